@@ -24,6 +24,17 @@ namespace P4::BMV2 {
 const int JSON_MAJOR_VERSION = 2;
 const int JSON_MINOR_VERSION = 23;
 
+void JsonNameValueList::write(Util::JsonWriter &writer) const {
+    writer.beginArray();
+    for (const auto &[name, value] : entries) {
+        writer.beginArray();
+        writer.value(Util::JsonValue(name));
+        writer.value(Util::JsonValue(value));
+        writer.endArray();
+    }
+    writer.endArray();
+}
+
 JsonObjects::JsonObjects() {
     toplevel = new Util::JsonObject();
     meta = new Util::JsonObject();
@@ -34,7 +45,8 @@ JsonObjects::JsonObjects() {
     header_unions = insert_array_field(toplevel, "header_unions"_cs);
     header_union_stacks = insert_array_field(toplevel, "header_union_stacks"_cs);
     field_lists = insert_array_field(toplevel, "field_lists"_cs);
-    errors = insert_array_field(toplevel, "errors"_cs);
+    errors = new JsonNameValueList();
+    toplevel->emplace("errors"_cs, errors);
     enums = insert_array_field(toplevel, "enums"_cs);
     parsers = insert_array_field(toplevel, "parsers"_cs);
     parse_vsets = insert_array_field(toplevel, "parse_vsets"_cs);
@@ -247,9 +259,7 @@ void JsonObjects::add_header_union_stack(const cstring &type, const cstring &nam
 }
 
 void JsonObjects::add_error(const cstring &name, const unsigned type) {
-    auto arr = append_array(errors);
-    arr->append(name);
-    arr->append(type);
+    errors->append(name, type);
 }
 
 void JsonObjects::add_enum(const cstring &enum_name, const cstring &entry_name,
@@ -259,19 +269,14 @@ void JsonObjects::add_enum(const cstring &enum_name, const cstring &entry_name,
     if (enum_json == nullptr) {  // first entry in a new enum
         enum_json = new Util::JsonObject();
         enum_json->emplace("name", enum_name);
-        auto entries = insert_array_field(enum_json, "entries"_cs);
-        auto entry = new Util::JsonArray();
-        entry->append(entry_name);
-        entry->append(entry_value);
-        entries->append(entry);
+        auto entries = new JsonNameValueList();
+        entries->append(entry_name, entry_value);
+        enum_json->emplace("entries"_cs, entries);
         enums->append(enum_json);
         LOG3("new enum object: " << enum_name << " " << entry_name << " " << entry_value);
     } else {  // add entry to existing enum
-        auto entries = enum_json->getAs<Util::JsonArray>("entries");
-        auto entry = new Util::JsonArray();
-        entry->append(entry_name);
-        entry->append(entry_value);
-        entries->append(entry);
+        auto entries = enum_json->getAs<JsonNameValueList>("entries");
+        entries->append(entry_name, entry_value);
         LOG3("new enum entry: " << enum_name << " " << entry_name << " " << entry_value);
     }
 }
@@ -363,10 +368,16 @@ unsigned JsonObjects::add_action(const cstring &name, Util::JsonArray *&params,
     action->emplace("id", id);
     action->emplace("runtime_data", params);
     action->emplace("primitives", body);
-    actions->append(action);
+    // Nothing refers to an action once it is added, so its tree is not kept.
+    actions->append(new Util::JsonFragment(action));
     return id;
 }
 
+void JsonObjects::add_pipeline(Util::JsonObject *pipeline) {
+    CHECK_NULL(pipeline);
+    pipelines->append(new Util::JsonFragment(pipeline));
+}
+
 void JsonObjects::add_extern_attribute(const cstring &name, const cstring &type,
                                        const cstring &value, Util::JsonArray *attributes) {
     auto attr = new Util::JsonObject();
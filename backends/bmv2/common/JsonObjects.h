@@ -18,12 +18,27 @@ limitations under the License.
 #define BACKENDS_BMV2_COMMON_JSONOBJECTS_H_
 
 #include <map>
+#include <utility>
+#include <vector>
 
 #include "lib/json.h"
 #include "lib/ordered_map.h"
 
 namespace P4::BMV2 {
 
+/// A JSON array of [name, value] pairs, as used for errors and enum entries. The pairs are kept
+/// as plain C++ values and only turned into JSON text, through a Util::JsonWriter, when the
+/// document is serialized; no JSON tree is built for them.
+class JsonNameValueList final : public Util::IJson {
+    std::vector<std::pair<cstring, unsigned>> entries;
+
+ public:
+    void append(cstring name, unsigned value) { entries.emplace_back(name, value); }
+    void write(Util::JsonWriter &writer) const override;
+
+    DECLARE_TYPEINFO(JsonNameValueList, Util::IJson);
+};
+
 class JsonObjects {
  public:
     /// @brief Finds an object in a JSON array by its name.
@@ -148,9 +163,16 @@ class JsonObjects {
     /// @param name The name of the action.
     /// @param params The runtime data parameters of the action.
     /// @param body The primitives body of the action.
+    /// The action is rendered to text right away, so @p params and @p body must not be modified
+    /// afterwards.
     /// @return The ID of the newly created action.
     unsigned add_action(const cstring &name, Util::JsonArray *&params, Util::JsonArray *&body);
 
+    /// @brief Adds a complete pipeline, with its tables, action profiles and conditionals, to
+    /// the JSON representation.
+    /// @param pipeline The pipeline, which must not be modified afterwards.
+    void add_pipeline(Util::JsonObject *pipeline);
+
     /// @brief Adds an extern attribute to the JSON representation.
     /// @param name The name of the attribute.
     /// @param type The type of the attribute.
@@ -206,7 +228,7 @@ class JsonObjects {
     Util::JsonArray *counters;
     Util::JsonArray *deparsers;
     Util::JsonArray *enums;
-    Util::JsonArray *errors;
+    JsonNameValueList *errors;
     Util::JsonArray *externs;
     Util::JsonArray *field_lists;
     Util::JsonArray *headers;
@@ -836,7 +836,7 @@ class ControlConverter : public Inspector {
             P4C_UNIMPLEMENTED("%1%: not yet handled", c);
         }
 
-        ctxt->json->pipelines->append(result);
+        ctxt->json->add_pipeline(result);
         return false;
     }
 
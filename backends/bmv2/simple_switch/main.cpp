@@ -26,6 +26,7 @@ limitations under the License.
 #include "backends/bmv2/simple_switch/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/frontendCache.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/frontend.h"
 #include "ir/ir.h"
@@ -64,21 +65,29 @@ int main(int argc, char *const argv[]) {
     const IR::ToplevelBlock *toplevel = nullptr;
 
     if (options.loadIRFromJson == false) {
-        program = P4::parseP4File(options);
-
-        if (program == nullptr || ::P4::errorCount() > 0) return 1;
-        try {
+        auto cache = P4::FrontendCache::open(options);
+        if (cache && (program = cache->load())) {
             P4::P4COptionPragmaParser optionsPragmaParser(true);
             program->apply(P4::ApplyOptionsPragmas(optionsPragmaParser));
-
-            P4::FrontEnd frontend;
-            frontend.addDebugHook(hook);
-            program = frontend.run(options, program);
-        } catch (const std::exception &bug) {
-            std::cerr << bug.what() << std::endl;
-            return 1;
+        } else {
+            if (cache) cache->record();
+            program = cache ? cache->parse(options) : P4::parseP4File(options);
+
+            if (program == nullptr || ::P4::errorCount() > 0) return 1;
+            try {
+                P4::P4COptionPragmaParser optionsPragmaParser(true);
+                program->apply(P4::ApplyOptionsPragmas(optionsPragmaParser));
+
+                P4::FrontEnd frontend;
+                frontend.addDebugHook(hook);
+                program = frontend.run(options, program);
+            } catch (const std::exception &bug) {
+                std::cerr << bug.what() << std::endl;
+                return 1;
+            }
+            if (program == nullptr || ::P4::errorCount() > 0) return 1;
+            if (cache) cache->store(program);
         }
-        if (program == nullptr || ::P4::errorCount() > 0) return 1;
     } else {
         std::filebuf fb;
         if (fb.open(options.file, std::ios::in) == nullptr) {
@@ -127,7 +127,8 @@ int main(int argc, char *const argv[]) {
     }
 
     if (::P4::errorCount() > 0) return 1;
-    auto p4info = *P4::generateP4Runtime(program, options.arch).p4Info;
+    auto p4info =
+        *P4::P4RuntimeSerializer::get()->generateP4Runtime(program, options.arch, false).p4Info;
     DPDK::DpdkMidEnd midEnd(options);
     midEnd.addDebugHook(hook);
     try {
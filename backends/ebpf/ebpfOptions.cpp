@@ -72,6 +72,14 @@ EbpfOptions::EbpfOptions() {
         },
         "Set number of maximum possible masks for a ternary key"
         " in a single table");
+    registerOption(
+        "--ternary-priority-order", nullptr,
+        [this](const char *) {
+            ternaryPriorityOrder = true;
+            return true;
+        },
+        "[psa only] Stop lookups in ternary tables with const entries once no remaining mask "
+        "can hold a better match");
     registerOption(
         "--xdp2tc", "MODE",
         [this](const char *arg) {
@@ -93,6 +101,22 @@ EbpfOptions::EbpfOptions() {
             return true;
         },
         "[psa only] Enable caching entries for tables with lpm or ternary key");
+    registerOption(
+        "--percpu-counters", nullptr,
+        [this](const char *) {
+            perCPUCounters = true;
+            return true;
+        },
+        "[psa only] Store indirect counters in per-CPU maps, updated without atomic "
+        "operations");
+    registerOption(
+        "--lock-free-meters", nullptr,
+        [this](const char *) {
+            lockFreeMeters = true;
+            return true;
+        },
+        "[psa only] Update meters with atomic compare-and-swap instead of spin locks "
+        "(requires BPF atomics, i.e. LLVM -mcpu=v3 and Linux 5.12 or newer)");
     registerOption(
         "--xdp", nullptr,
         [this](const char *) {
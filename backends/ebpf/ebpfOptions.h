@@ -39,8 +39,14 @@ class EbpfOptions : public CompilerOptions {
     enum XDP2TC xdp2tcMode = XDP2TC_NONE;
     /// maximum number of unique ternary masks
     unsigned int maxTernaryMasks = 128;
+    /// Ternary masks are ordered by the highest priority of their entries
+    bool ternaryPriorityOrder = false;
     /// Enable table cache for LPM and ternary tables
     bool enableTableCache = false;
+    /// Store indirect counters in per-CPU maps
+    bool perCPUCounters = false;
+    /// Update meters with compare-and-swap instead of spin locks
+    bool lockFreeMeters = false;
 
     EbpfOptions();
 
@@ -283,6 +283,10 @@ void EBPFTable::emitValueType(CodeBuilder *builder) {
         builder->newline();
         builder->emitIndent();
         builder->appendLine("__u8 has_next;");
+        if (hasPriorityOrderedMasks()) {
+            builder->emitIndent();
+            builder->appendLine("__u32 max_priority;");
+        }
         builder->blockEnd(false);
         builder->endOfStatement(true);
     }
@@ -765,6 +769,19 @@ void EBPFTable::emitLookup(CodeBuilder *builder, cstring key, cstring value) {
     builder->emitIndent();
     builder->appendLine("break;");
     builder->blockEnd(true);
+    if (hasPriorityOrderedMasks()) {
+        // Masks are ordered by the highest priority of their entries, so no remaining mask can
+        // hold a better match than the current one.
+        builder->emitIndent();
+        builder->appendFormat("if (%v != NULL && v->max_priority <= %v->priority) ", value,
+                              value);
+        builder->blockStart();
+        builder->target->emitTraceMessage(builder,
+                                          "Control: No better ternary match left, stopping");
+        builder->emitIndent();
+        builder->appendLine("break;");
+        builder->blockEnd(true);
+    }
     builder->emitIndent();
     cstring new_key = "k"_cs;
     builder->appendFormat("struct %v %v = {};", keyTypeName, new_key);
@@ -883,6 +900,14 @@ bool EBPFTable::isLPMTable() const {
     return isLPM;
 }
 
+bool EBPFTable::hasPriorityOrderedMasks() const {
+    if (!program->options.ternaryPriorityOrder || table == nullptr) return false;
+    // Masks of entries added at runtime are not ordered by the control plane.
+    const auto *entries =
+        table->container->properties->getProperty(IR::TableProperties::entriesPropertyName);
+    return entries != nullptr && entries->isConstant;
+}
+
 bool EBPFTable::isTernaryTable() const {
     if (keyGenerator != nullptr) {
         // If any key field is a ternary field we will generate a ternary table
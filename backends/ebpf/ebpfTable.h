@@ -77,6 +77,10 @@ class EBPFTable : public EBPFTableBase {
  public:
     bool isLPMTable() const;
     bool isTernaryTable() const;
+    /// @returns true if lookups in this ternary table stop at the first mask that cannot hold a
+    /// better match (--ternary-priority-order). This relies on the masks being linked in order
+    /// of priority, which only the compiler guarantees, i.e., for tables with `const entries`.
+    bool hasPriorityOrderedMasks() const;
 
  protected:
     void emitTernaryInstance(CodeBuilder *builder);
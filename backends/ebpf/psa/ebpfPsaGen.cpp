@@ -308,8 +308,8 @@ void PSAEbpfGenerator::emitHelperFunctions(CodeBuilder *builder) const {
     builder->newline();
 
     if (ingress->hasAnyMeter() || egress->hasAnyMeter()) {
-        cstring meterExecuteFunc =
-            EBPFMeterPSA::meterExecuteFunc(options.emitTraceMessages, ingress->refMap);
+        cstring meterExecuteFunc = EBPFMeterPSA::meterExecuteFunc(
+            options.emitTraceMessages, options.lockFreeMeters, ingress->refMap);
         builder->appendLine(meterExecuteFunc);
         builder->newline();
     }
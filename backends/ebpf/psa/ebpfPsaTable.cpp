@@ -715,7 +715,8 @@ void EBPFTablePSA::emitTernaryConstEntriesInitializer(CodeBuilder *builder) {
         } else {
             nextMask = nullptr;
         }
-        emitValueMask(builder, valueMask, nextMask, tuple_id);
+        // Entries of a group are in descending priority order.
+        emitValueMask(builder, valueMask, nextMask, tuple_id, sameMaskEntries.front().priority);
         builder->newline();
         emitKeysAndValues(builder, sameMaskEntries, keyNames, valueNames);
 
@@ -814,7 +815,7 @@ void EBPFTablePSA::emitKeyMasks(CodeBuilder *builder, EntriesGroupedByMask_t &en
 }
 
 void EBPFTablePSA::emitValueMask(CodeBuilder *builder, const cstring valueMask,
-                                 const cstring nextMask, int tupleId) const {
+                                 const cstring nextMask, int tupleId, unsigned maxPriority) const {
     builder->emitIndent();
     builder->appendFormat("struct %v_mask %v = {0}", valueTypeName, valueMask);
     builder->endOfStatement(true);
@@ -822,6 +823,11 @@ void EBPFTablePSA::emitValueMask(CodeBuilder *builder, const cstring valueMask,
     builder->emitIndent();
     builder->appendFormat("%v.tuple_id = %d", valueMask, tupleId);
     builder->endOfStatement(true);
+    if (hasPriorityOrderedMasks()) {
+        builder->emitIndent();
+        builder->appendFormat("%v.max_priority = %u", valueMask, maxPriority);
+        builder->endOfStatement(true);
+    }
     builder->emitIndent();
     if (nextMask.isNullOrEmpty()) {
         builder->appendFormat("%v.has_next = 0", valueMask);
@@ -846,9 +852,10 @@ EBPFTablePSA::EntriesGroupedByMask_t EBPFTablePSA::getConstEntriesGroupedByMask(
     if (!entries) return result;
 
     // Group entries by the same mask, container will do deduplication for us. The order of
-    // entries will be changed but this is not a problem because of priority. Ebpf algorithm use
-    // TSS, so every mask have to be tested and there is no strict requirements on masks order.
-    // Priority of entries is equal to P4 program order (first defined has the highest priority).
+    // entries will be changed but this is not a problem because of priority. Groups are then
+    // sorted by the highest priority of their entries, which lets lookups stop early with
+    // --ternary-priority-order. Priority of entries is equal to P4 program order (first
+    // defined has the highest priority).
     EBPFTablePSATernaryTableMaskGenerator maskGenerator(program->refMap, program->typeMap);
     std::unordered_map<cstring, std::vector<ConstTernaryEntryDesc>> entriesGroupedByMask;
     unsigned priority = entries->entries.size() + 1;
@@ -864,6 +871,9 @@ EBPFTablePSA::EntriesGroupedByMask_t EBPFTablePSA::getConstEntriesGroupedByMask(
     for (auto &vec : entriesGroupedByMask) {
         result.emplace_back(std::move(vec.second));
     }
+    std::sort(result.begin(), result.end(), [](const auto &a, const auto &b) {
+        return a.front().priority > b.front().priority;
+    });
     return result;
 }
 
@@ -60,8 +60,8 @@ class EBPFTablePSA : public EBPFTable {
     void emitConstEntriesInitializer(CodeBuilder *builder);
     void emitTernaryConstEntriesInitializer(CodeBuilder *builder);
     void emitMapUpdateTraceMsg(CodeBuilder *builder, cstring mapName, cstring returnCode) const;
-    void emitValueMask(CodeBuilder *builder, cstring valueMask, cstring nextMask,
-                       int tupleId) const;
+    void emitValueMask(CodeBuilder *builder, cstring valueMask, cstring nextMask, int tupleId,
+                       unsigned maxPriority = 0) const;
     void emitKeyMasks(CodeBuilder *builder, EntriesGroupedByMask_t &entriesGroupedByMask,
                       std::vector<cstring> &keyMasksNames);
     void emitKeysAndValues(CodeBuilder *builder, EntriesGroup_t &sameMaskEntries,
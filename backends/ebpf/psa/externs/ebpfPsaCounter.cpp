@@ -22,6 +22,8 @@ limitations under the License.
 
 namespace P4::EBPF {
 
+const cstring EBPFCounterPSA::perCPUAnnotation = "percpu"_cs;
+
 EBPFCounterPSA::EBPFCounterPSA(const EBPFProgram *program, const IR::Declaration_Instance *di,
                                cstring name, CodeGenInspector *codeGen)
     : EBPFCounterTable(program, name, codeGen, 1, false) {
@@ -112,6 +114,15 @@ EBPFCounterPSA::EBPFCounterPSA(const EBPFProgram *program, const IR::Declaration
         size = declaredSize->asUnsigned();
     }
 
+    // Direct counters are stored in table entries, which are shared by all CPUs.
+    bool perCPURequested = di->hasAnnotation(perCPUAnnotation);
+    if (isDirect && perCPURequested) {
+        ::P4::warning(ErrorType::WARN_UNSUPPORTED,
+                      "%1%: per-CPU storage is not supported for DirectCounter, ignoring", di);
+    } else if (!isDirect) {
+        isPerCPU = perCPURequested || program->options.perCPUCounters;
+    }
+
     auto typeArg = di->arguments->at(di->arguments->size() - 1)->expression->to<IR::Constant>();
     type = toCounterType(typeArg->asInt());
 }
@@ -168,6 +179,10 @@ void EBPFCounterPSA::emitValueType(CodeBuilder *builder) {
 
 void EBPFCounterPSA::emitInstance(CodeBuilder *builder) {
     TableKind kind = isHash ? TableHash : TableArray;
+    if (isPerCPU) {
+        BUG_CHECK(!isHash, "%1%: per-CPU hash maps are not supported for counters", instanceName);
+        kind = TablePerCPUArray;
+    }
     builder->target->emitTableDecl(builder, dataMapName, kind, keyTypeName,
                                    "struct " + valueTypeName, size);
 }
@@ -260,8 +275,11 @@ void EBPFCounterPSA::emitCounterUpdate(CodeBuilder *builder, const cstring targe
 
     if (type == CounterType::BYTES || type == CounterType::PACKETS_AND_BYTES) {
         builder->emitIndent();
-        builder->appendFormat("__sync_fetch_and_add(&(%vbytes), %v)", targetWAccess,
-                              program->lengthVar);
+        if (isPerCPU)
+            builder->appendFormat("%vbytes += %v", targetWAccess, program->lengthVar);
+        else
+            builder->appendFormat("__sync_fetch_and_add(&(%vbytes), %v)", targetWAccess,
+                                  program->lengthVar);
         builder->endOfStatement(true);
 
         varStr = absl::StrFormat("%sbytes", targetWAccess.c_str());
@@ -269,7 +287,10 @@ void EBPFCounterPSA::emitCounterUpdate(CodeBuilder *builder, const cstring targe
     }
     if (type == CounterType::PACKETS || type == CounterType::PACKETS_AND_BYTES) {
         builder->emitIndent();
-        builder->appendFormat("__sync_fetch_and_add(&(%spackets), 1)", targetWAccess.c_str());
+        if (isPerCPU)
+            builder->appendFormat("%vpackets += 1", targetWAccess);
+        else
+            builder->appendFormat("__sync_fetch_and_add(&(%spackets), 1)", targetWAccess.c_str());
         builder->endOfStatement(true);
 
         varStr = absl::StrFormat("%spackets", targetWAccess.c_str());
@@ -28,11 +28,16 @@ class EBPFCounterPSA : public EBPFCounterTable {
     EBPFType *dataplaneWidthType;
     EBPFType *indexWidthType;
     bool isDirect;
+    /// True if each CPU updates its own copy of the counters; readers sum the copies.
+    bool isPerCPU = false;
 
  public:
     enum CounterType { PACKETS, BYTES, PACKETS_AND_BYTES };
     CounterType type;
 
+    /// Annotation on a Counter instance requesting per-CPU storage.
+    static const cstring perCPUAnnotation;
+
     EBPFCounterPSA(const EBPFProgram *program, const IR::Declaration_Instance *di, cstring name,
                    CodeGenInspector *codeGen);
 
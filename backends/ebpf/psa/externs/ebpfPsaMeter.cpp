@@ -229,120 +229,221 @@ void EBPFMeterPSA::emitDirectExecute(CodeBuilder *builder, const P4::ExternMetho
     builder->append(")");
 }
 
-cstring EBPFMeterPSA::meterExecuteFunc(bool trace, P4::ReferenceMap *refMap) {
-    cstring meterExecuteFunc =
-        "static __always_inline\n"
-        "enum PSA_MeterColor_t meter_execute(%meter_struct% *value, "
-        "void *lock, "
-        "u32 *packet_len, u64 *time_ns) {\n"
-        "    if (value != NULL && value->pir_period != 0) {\n"
-        "        u64 delta_p, delta_c;\n"
-        "        u64 n_periods_p, n_periods_c, tokens_pbs, tokens_cbs;\n"
-        "        bpf_spin_lock(lock);\n"
-        "        delta_p = *time_ns - value->time_p;\n"
-        "        delta_c = *time_ns - value->time_c;\n"
-        "\n"
-        "        n_periods_p = delta_p / value->pir_period;\n"
-        "        n_periods_c = delta_c / value->cir_period;\n"
-        "\n"
-        "        value->time_p += n_periods_p * value->pir_period;\n"
-        "        value->time_c += n_periods_c * value->cir_period;\n"
-        "\n"
-        "        tokens_pbs = value->pbs_left + "
-        "n_periods_p * value->pir_unit_per_period;\n"
-        "        if (tokens_pbs > value->pbs) {\n"
-        "            tokens_pbs = value->pbs;\n"
-        "        }\n"
-        "        tokens_cbs = value->cbs_left + "
-        "n_periods_c * value->cir_unit_per_period;\n"
-        "        if (tokens_cbs > value->cbs) {\n"
-        "            tokens_cbs = value->cbs;\n"
-        "        }\n"
-        "\n"
-        "        if (*packet_len > tokens_pbs) {\n"
-        "            value->pbs_left = tokens_pbs;\n"
-        "            value->cbs_left = tokens_cbs;\n"
-        "            bpf_spin_unlock(lock);\n"
-        "%trace_msg_meter_red%"
-        "            return RED;\n"
-        "        }\n"
-        "\n"
-        "        if (*packet_len > tokens_cbs) {\n"
-        "            value->pbs_left = tokens_pbs - *packet_len;\n"
-        "            value->cbs_left = tokens_cbs;\n"
-        "            bpf_spin_unlock(lock);\n"
-        "%trace_msg_meter_yellow%"
-        "            return YELLOW;\n"
-        "        }\n"
-        "\n"
-        "        value->pbs_left = tokens_pbs - *packet_len;\n"
-        "        value->cbs_left = tokens_cbs - *packet_len;\n"
-        "        bpf_spin_unlock(lock);\n"
-        "%trace_msg_meter_green%"
-        "        return GREEN;\n"
-        "    } else {\n"
-        "        // From P4Runtime spec. No value - return default GREEN.\n"
-        "%trace_msg_meter_no_value%"
-        "        return GREEN;\n"
-        "    }\n"
-        "}\n"
-        "\n"
-        "static __always_inline\n"
-        "enum PSA_MeterColor_t meter_execute_color_aware(%meter_struct% *value, "
-        "void *lock, "
-        "u32 *packet_len, u64 *time_ns, enum PSA_MeterColor_t color) {\n"
-        "    if (value != NULL && value->pir_period != 0) {\n"
-        "        u64 delta_p, delta_c;\n"
-        "        u64 n_periods_p, n_periods_c, tokens_pbs, tokens_cbs;\n"
-        "        bpf_spin_lock(lock);\n"
-        "        delta_p = *time_ns - value->time_p;\n"
-        "        delta_c = *time_ns - value->time_c;\n"
-        "\n"
-        "        n_periods_p = delta_p / value->pir_period;\n"
-        "        n_periods_c = delta_c / value->cir_period;\n"
-        "\n"
-        "        value->time_p += n_periods_p * value->pir_period;\n"
-        "        value->time_c += n_periods_c * value->cir_period;\n"
-        "\n"
-        "        tokens_pbs = value->pbs_left + "
-        "n_periods_p * value->pir_unit_per_period;\n"
-        "        if (tokens_pbs > value->pbs) {\n"
-        "            tokens_pbs = value->pbs;\n"
-        "        }\n"
-        "        tokens_cbs = value->cbs_left + "
-        "n_periods_c * value->cir_unit_per_period;\n"
-        "        if (tokens_cbs > value->cbs) {\n"
-        "            tokens_cbs = value->cbs;\n"
-        "        }\n"
-        "\n"
-        "        if ((color == RED) || (*packet_len > tokens_pbs)) {\n"
-        "            value->pbs_left = tokens_pbs;\n"
-        "            value->cbs_left = tokens_cbs;\n"
-        "            bpf_spin_unlock(lock);\n"
-        "%trace_msg_meter_red%"
-        "            return RED;\n"
-        "        }\n"
-        "\n"
-        "        if ((color == YELLOW) || (*packet_len > tokens_cbs)) {\n"
-        "            value->pbs_left = tokens_pbs - *packet_len;\n"
-        "            value->cbs_left = tokens_cbs;\n"
-        "            bpf_spin_unlock(lock);\n"
-        "%trace_msg_meter_yellow%"
-        "            return YELLOW;\n"
-        "        }\n"
-        "\n"
-        "        value->pbs_left = tokens_pbs - *packet_len;\n"
-        "        value->cbs_left = tokens_cbs - *packet_len;\n"
-        "        bpf_spin_unlock(lock);\n"
-        "%trace_msg_meter_green%"
-        "        return GREEN;\n"
-        "    } else {\n"
-        "        // From P4Runtime spec. No value - return default GREEN.\n"
-        "%trace_msg_meter_no_value%"
-        "        return GREEN;\n"
-        "    }\n"
-        "}\n"
-        "\n"
+cstring EBPFMeterPSA::meterExecuteFunc(bool trace, bool lockFree, P4::ReferenceMap *refMap) {
+    cstring meterExecuteFunc;
+    if (lockFree) {
+        // Each bucket is updated with a compare-and-swap on its timestamp, which then holds the
+        // time at which the bucket will be full again (GCRA). pbs_left and cbs_left are only
+        // updated for the control plane to read. Requires BPF atomics (-mcpu=v3).
+        meterExecuteFunc =
+            "#define METER_CAS_RETRIES 8\n"
+            "\n"
+            "static __always_inline\n"
+            "int meter_consume(u64 *tat, u64 *left, u32 packet_len, u64 period, "
+            "u64 unit_per_period, u64 bs, u64 now) {\n"
+            "    // The bucket is full whenever tat <= now and otherwise holds\n"
+            "    // (now + burst - tat) worth of tokens. The cost is rounded up, and is at\n"
+            "    // least 1ns, so that packets of high-rate meters are never free.\n"
+            "    u64 cost = (packet_len * period + unit_per_period - 1) / unit_per_period;\n"
+            "    u64 burst = bs * period / unit_per_period;\n"
+            "    if (cost == 0)\n"
+            "        cost = 1;\n"
+            "#pragma unroll\n"
+            "    for (int i = 0; i < METER_CAS_RETRIES; i++) {\n"
+            "        u64 old = *(volatile u64 *)tat;\n"
+            "        u64 start = old > now ? old : now;\n"
+            "        u64 next = start + cost;\n"
+            "        if (next - now > burst) {\n"
+            "            // tat may be past now + burst after the atomic add below.\n"
+            "            u64 used = start - now;\n"
+            "            *left = used < burst ? (burst - used) * unit_per_period / period : 0;\n"
+            "            return 0;\n"
+            "        }\n"
+            "        if (__sync_val_compare_and_swap(tat, old, next) == old) {\n"
+            "            *left = (burst - (next - now)) * unit_per_period / period;\n"
+            "            return 1;\n"
+            "        }\n"
+            "    }\n"
+            "    // Every attempt raced with other CPUs charging the same bucket. Charge the\n"
+            "    // packet with an atomic add, which cannot fail, so that contention alone\n"
+            "    // never marks a packet, and take the charge back if it overflows the bucket.\n"
+            "    u64 next = __sync_fetch_and_add(tat, cost) + cost;\n"
+            "    if (next > now + burst) {\n"
+            "        __sync_fetch_and_add(tat, -cost);\n"
+            "        *left = 0;\n"
+            "        return 0;\n"
+            "    }\n"
+            "    *left = (burst - (next > now ? next - now : 0)) * unit_per_period / period;\n"
+            "    return 1;\n"
+            "}\n"
+            "\n"
+            "static __always_inline\n"
+            "enum PSA_MeterColor_t meter_execute(%meter_struct% *value, "
+            "void *lock, "
+            "u32 *packet_len, u64 *time_ns) {\n"
+            "    if (value != NULL && value->pir_period != 0) {\n"
+            "        if (!meter_consume(&value->time_p, &value->pbs_left, *packet_len, "
+            "value->pir_period, value->pir_unit_per_period, value->pbs, *time_ns)) {\n"
+            "%trace_msg_meter_red%"
+            "            return RED;\n"
+            "        }\n"
+            "        if (!meter_consume(&value->time_c, &value->cbs_left, *packet_len, "
+            "value->cir_period, value->cir_unit_per_period, value->cbs, *time_ns)) {\n"
+            "%trace_msg_meter_yellow%"
+            "            return YELLOW;\n"
+            "        }\n"
+            "%trace_msg_meter_green%"
+            "        return GREEN;\n"
+            "    } else {\n"
+            "        // From P4Runtime spec. No value - return default GREEN.\n"
+            "%trace_msg_meter_no_value%"
+            "        return GREEN;\n"
+            "    }\n"
+            "}\n"
+            "\n"
+            "static __always_inline\n"
+            "enum PSA_MeterColor_t meter_execute_color_aware(%meter_struct% *value, "
+            "void *lock, "
+            "u32 *packet_len, u64 *time_ns, enum PSA_MeterColor_t color) {\n"
+            "    if (value != NULL && value->pir_period != 0) {\n"
+            "        if ((color == RED) || !meter_consume(&value->time_p, &value->pbs_left, "
+            "*packet_len, value->pir_period, value->pir_unit_per_period, value->pbs, "
+            "*time_ns)) {\n"
+            "%trace_msg_meter_red%"
+            "            return RED;\n"
+            "        }\n"
+            "        if ((color == YELLOW) || !meter_consume(&value->time_c, &value->cbs_left, "
+            "*packet_len, value->cir_period, value->cir_unit_per_period, value->cbs, "
+            "*time_ns)) {\n"
+            "%trace_msg_meter_yellow%"
+            "            return YELLOW;\n"
+            "        }\n"
+            "%trace_msg_meter_green%"
+            "        return GREEN;\n"
+            "    } else {\n"
+            "        // From P4Runtime spec. No value - return default GREEN.\n"
+            "%trace_msg_meter_no_value%"
+            "        return GREEN;\n"
+            "    }\n"
+            "}\n"
+            "\n"_cs;
+    } else {
+        meterExecuteFunc =
+            "static __always_inline\n"
+            "enum PSA_MeterColor_t meter_execute(%meter_struct% *value, "
+            "void *lock, "
+            "u32 *packet_len, u64 *time_ns) {\n"
+            "    if (value != NULL && value->pir_period != 0) {\n"
+            "        u64 delta_p, delta_c;\n"
+            "        u64 n_periods_p, n_periods_c, tokens_pbs, tokens_cbs;\n"
+            "        bpf_spin_lock(lock);\n"
+            "        delta_p = *time_ns - value->time_p;\n"
+            "        delta_c = *time_ns - value->time_c;\n"
+            "\n"
+            "        n_periods_p = delta_p / value->pir_period;\n"
+            "        n_periods_c = delta_c / value->cir_period;\n"
+            "\n"
+            "        value->time_p += n_periods_p * value->pir_period;\n"
+            "        value->time_c += n_periods_c * value->cir_period;\n"
+            "\n"
+            "        tokens_pbs = value->pbs_left + "
+            "n_periods_p * value->pir_unit_per_period;\n"
+            "        if (tokens_pbs > value->pbs) {\n"
+            "            tokens_pbs = value->pbs;\n"
+            "        }\n"
+            "        tokens_cbs = value->cbs_left + "
+            "n_periods_c * value->cir_unit_per_period;\n"
+            "        if (tokens_cbs > value->cbs) {\n"
+            "            tokens_cbs = value->cbs;\n"
+            "        }\n"
+            "\n"
+            "        if (*packet_len > tokens_pbs) {\n"
+            "            value->pbs_left = tokens_pbs;\n"
+            "            value->cbs_left = tokens_cbs;\n"
+            "            bpf_spin_unlock(lock);\n"
+            "%trace_msg_meter_red%"
+            "            return RED;\n"
+            "        }\n"
+            "\n"
+            "        if (*packet_len > tokens_cbs) {\n"
+            "            value->pbs_left = tokens_pbs - *packet_len;\n"
+            "            value->cbs_left = tokens_cbs;\n"
+            "            bpf_spin_unlock(lock);\n"
+            "%trace_msg_meter_yellow%"
+            "            return YELLOW;\n"
+            "        }\n"
+            "\n"
+            "        value->pbs_left = tokens_pbs - *packet_len;\n"
+            "        value->cbs_left = tokens_cbs - *packet_len;\n"
+            "        bpf_spin_unlock(lock);\n"
+            "%trace_msg_meter_green%"
+            "        return GREEN;\n"
+            "    } else {\n"
+            "        // From P4Runtime spec. No value - return default GREEN.\n"
+            "%trace_msg_meter_no_value%"
+            "        return GREEN;\n"
+            "    }\n"
+            "}\n"
+            "\n"
+            "static __always_inline\n"
+            "enum PSA_MeterColor_t meter_execute_color_aware(%meter_struct% *value, "
+            "void *lock, "
+            "u32 *packet_len, u64 *time_ns, enum PSA_MeterColor_t color) {\n"
+            "    if (value != NULL && value->pir_period != 0) {\n"
+            "        u64 delta_p, delta_c;\n"
+            "        u64 n_periods_p, n_periods_c, tokens_pbs, tokens_cbs;\n"
+            "        bpf_spin_lock(lock);\n"
+            "        delta_p = *time_ns - value->time_p;\n"
+            "        delta_c = *time_ns - value->time_c;\n"
+            "\n"
+            "        n_periods_p = delta_p / value->pir_period;\n"
+            "        n_periods_c = delta_c / value->cir_period;\n"
+            "\n"
+            "        value->time_p += n_periods_p * value->pir_period;\n"
+            "        value->time_c += n_periods_c * value->cir_period;\n"
+            "\n"
+            "        tokens_pbs = value->pbs_left + "
+            "n_periods_p * value->pir_unit_per_period;\n"
+            "        if (tokens_pbs > value->pbs) {\n"
+            "            tokens_pbs = value->pbs;\n"
+            "        }\n"
+            "        tokens_cbs = value->cbs_left + "
+            "n_periods_c * value->cir_unit_per_period;\n"
+            "        if (tokens_cbs > value->cbs) {\n"
+            "            tokens_cbs = value->cbs;\n"
+            "        }\n"
+            "\n"
+            "        if ((color == RED) || (*packet_len > tokens_pbs)) {\n"
+            "            value->pbs_left = tokens_pbs;\n"
+            "            value->cbs_left = tokens_cbs;\n"
+            "            bpf_spin_unlock(lock);\n"
+            "%trace_msg_meter_red%"
+            "            return RED;\n"
+            "        }\n"
+            "\n"
+            "        if ((color == YELLOW) || (*packet_len > tokens_cbs)) {\n"
+            "            value->pbs_left = tokens_pbs - *packet_len;\n"
+            "            value->cbs_left = tokens_cbs;\n"
+            "            bpf_spin_unlock(lock);\n"
+            "%trace_msg_meter_yellow%"
+            "            return YELLOW;\n"
+            "        }\n"
+            "\n"
+            "        value->pbs_left = tokens_pbs - *packet_len;\n"
+            "        value->cbs_left = tokens_cbs - *packet_len;\n"
+            "        bpf_spin_unlock(lock);\n"
+            "%trace_msg_meter_green%"
+            "        return GREEN;\n"
+            "    } else {\n"
+            "        // From P4Runtime spec. No value - return default GREEN.\n"
+            "%trace_msg_meter_no_value%"
+            "        return GREEN;\n"
+            "    }\n"
+            "}\n"
+            "\n"_cs;
+    }
+
+    meterExecuteFunc +=
         "static __always_inline\n"
         "enum PSA_MeterColor_t meter_execute_bytes_value("
         "void *value, void *lock, u32 *packet_len, "
@@ -59,7 +59,9 @@ class EBPFMeterPSA : public EBPFTableBase {
     void emitDirectExecute(CodeBuilder *builder, const P4::ExternMethod *method,
                            cstring valuePtr) const;
 
-    static cstring meterExecuteFunc(bool trace, P4::ReferenceMap *refMap);
+    /// @param lockFree selects the implementation that updates meters with atomic
+    /// compare-and-swap instead of a BPF spin lock.
+    static cstring meterExecuteFunc(bool trace, bool lockFree, P4::ReferenceMap *refMap);
 };
 
 }  // namespace P4::EBPF
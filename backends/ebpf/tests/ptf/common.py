@@ -80,6 +80,8 @@ class P4EbpfTest(BaseTest):
     switch_ns = "test"
     p4_file_path = ""
     p4c_additional_args = ""
+    # Flags for llc, e.g. to enable newer BPF instructions; kernel.mk's default if empty
+    llc_flags = ""
     p4info_reference_file_path = ""
 
     def setUp(self):
@@ -136,11 +138,15 @@ class P4EbpfTest(BaseTest):
         p4args = p4args + " " + self.p4c_additional_args
 
         logger.info("P4ARGS=" + p4args)
+        make_args = ""
+        if self.llc_flags:
+            make_args = 'LLC_FLAGS="{}" '.format(self.llc_flags)
         self.exec_cmd(
-            "make -f ../runtime/kernel.mk BPFOBJ={output} P4FILE={p4file} "
+            "make -f ../runtime/kernel.mk BPFOBJ={output} P4FILE={p4file} {make_args}"
             "ARGS=\"{cargs}\" P4C=p4c-ebpf P4ARGS=\"{p4args}\" psa".format(
                 output=self.test_prog_image,
                 p4file=self.p4_file_path,
+                make_args=make_args,
                 cargs="-DPSA_PORT_RECIRCULATE={}".format(
                     self.get_dataplane_port_number("psa_recirc")
                 ),
@@ -232,6 +238,23 @@ class P4EbpfTest(BaseTest):
         value = [format(int(v, 0), "02x") for v in json.loads(stdout)["value"]]
         return " ".join(value)
 
+    def read_percpu_counter(self, name, index, width):
+        """Reads entry `index` of a counter stored in a per-CPU map and sums it over all CPUs.
+        Returns the counter fields (bytes and/or packets, in declaration order) of `width` bits.
+        """
+        key = " ".join(str(b) for b in index.to_bytes(4, "little"))
+        cmd = "bpftool -j map lookup pinned {}/{} key {}".format(
+            PIPELINE_MAPS_MOUNT_PATH, name, key
+        )
+        _, stdout, _ = self.exec_ns_cmd(cmd, "Failed to read map {}".format(name))
+        size = width // 8
+        sums = None
+        for entry in json.loads(stdout)["values"]:
+            raw = bytes(int(v, 0) for v in entry["value"])
+            fields = [int.from_bytes(raw[i : i + size], "little") for i in range(0, len(raw), size)]
+            sums = fields if sums is None else [a + b for a, b in zip(sums, fields)]
+        return sums
+
     def verify_map_entry(self, name, key, expected_value, mask=None):
         value = self.read_map(name, key)
 
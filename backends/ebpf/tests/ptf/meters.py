@@ -15,6 +15,8 @@
 # limitations under the License.
 
 import math
+import threading
+import time
 
 from common import *
 
@@ -175,6 +177,66 @@ class MeterColorAwarePSATest(P4EbpfTest):
         )
 
 
+class LockFreeMeterPSATest(MeterPSATest):
+    """
+    Same as MeterPSATest, with meters updated by compare-and-swap instead of spin locks.
+    """
+
+    p4c_additional_args = "--lock-free-meters"
+    llc_flags = "-mcpu=v3"
+
+
+class LockFreeMeterConcurrentPSATest(P4EbpfTest):
+    """
+    Test lock-free Meter updated by concurrent senders. Type BYTES.
+    Send more traffic than the buckets hold from two ports at once and verify that the meter
+    does not let more than its buckets and rate allow through, and that pbs_left and cbs_left
+    stay within the bucket sizes.
+    """
+
+    p4_file_path = "p4testdata/meters.p4"
+    p4c_additional_args = "--lock-free-meters"
+    llc_flags = "-mcpu=v3"
+
+    def read_buckets_left(self):
+        value = bytes(int(b, 16) for b in self.read_map("ingress_meter1", "hex 00").split())
+        # pbs_left and cbs_left are the 7th and 8th 8-byte fields of the meter value
+        return [int.from_bytes(value[i * 8 : (i + 1) * 8], "little") for i in (6, 7)]
+
+    def runTest(self):
+        pkt = testutils.simple_ip_packet()
+        # cir, pir -> 1000 byte/s, cbs, pbs -> 2500 B: 25 packets of 100 B, plus 10 packets/s
+        self.meter_update(name="ingress_meter1", index=0, pir=1000, pbs=2500, cir=1000, cbs=2500)
+
+        def send(port):
+            for _ in range(50):
+                testutils.send_packet(self, port, pkt)
+
+        start = time.time()
+        senders = [threading.Thread(target=send, args=(port,)) for port in (PORT0, PORT2)]
+        for sender in senders:
+            sender.start()
+        for sender in senders:
+            sender.join()
+        received = testutils.count_matched_packets(self, pkt, PORT1, timeout=1)
+        elapsed = time.time() - start
+
+        allowed = 25 + math.ceil(elapsed * 10)
+        self.assertGreater(received, 0)
+        self.assertLessEqual(received, allowed)
+        for left in self.read_buckets_left():
+            self.assertLessEqual(left, 2500)
+
+
+class LockFreeMeterColorAwarePSATest(MeterColorAwarePSATest):
+    """
+    Same as MeterColorAwarePSATest, with meters updated by compare-and-swap.
+    """
+
+    p4c_additional_args = "--lock-free-meters"
+    llc_flags = "-mcpu=v3"
+
+
 class MeterActionPSATest(P4EbpfTest):
     """
     Test Meter used in action. Type BYTES.
@@ -273,6 +335,15 @@ class DirectMeterPSATest(P4EbpfTest):
         )
 
 
+class LockFreeDirectMeterPSATest(DirectMeterPSATest):
+    """
+    Same as DirectMeterPSATest, with meters updated by compare-and-swap.
+    """
+
+    p4c_additional_args = "--lock-free-meters"
+    llc_flags = "-mcpu=v3"
+
+
 class DirectMeterColorAwarePSATest(P4EbpfTest):
     """
     Test color-aware Direct Meter. Type BYTES. Pre coloured with YELLOW.
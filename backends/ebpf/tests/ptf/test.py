@@ -429,6 +429,28 @@ class CountersPSATest(P4EbpfTest):
         self.counter_verify(name="ingress_action_cnt", key=[DP_PORTS[1]], bytes=299, packets=2)
 
 
+class PerCPUCountersPSATest(P4EbpfTest):
+    """
+    Same counters as CountersPSATest, stored in per-CPU maps.
+    """
+
+    p4_file_path = "p4testdata/counters.p4"
+    p4c_additional_args = "--percpu-counters"
+
+    def runTest(self):
+        for src, length in [("00:AA:00:00:00:01", 100), ("00:AA:00:00:01:FE", 199)]:
+            pkt = testutils.simple_ip_packet(
+                eth_dst="00:11:22:33:44:55", eth_src=src, pktlen=length
+            )
+            testutils.send_packet(self, PORT0, pkt)
+            testutils.verify_packet_any_port(self, pkt, PTF_PORTS)
+
+        self.assertEqual(self.read_percpu_counter("ingress_test1_cnt", 1, 64), [100])
+        self.assertEqual(self.read_percpu_counter("ingress_test2_cnt", 0x1FE, 32), [1])
+        self.assertEqual(self.read_percpu_counter("ingress_test3_cnt", 0x1FE, 32), [199, 1])
+        self.assertEqual(self.read_percpu_counter("ingress_action_cnt", DP_PORTS[1], 64), [299, 2])
+
+
 class DirectCountersPSATest(P4EbpfTest):
     p4_file_path = "p4testdata/direct-counters.p4"
 
@@ -717,6 +739,24 @@ class ConstEntryTernaryPSATest(P4EbpfTest):
         testutils.verify_packet(self, pkt, PORT1)
 
 
+class PSATernaryPriorityOrderTest(PSATernaryTest):
+    """
+    Same as PSATernaryTest with --ternary-priority-order, which must not affect tables whose
+    entries are added at runtime.
+    """
+
+    p4c_additional_args = "--ternary-priority-order"
+
+
+class ConstEntryTernaryPriorityOrderPSATest(ConstEntryTernaryPSATest):
+    """
+    Same as ConstEntryTernaryPSATest, with lookups stopping at the first mask that cannot hold
+    a better match.
+    """
+
+    p4c_additional_args = "--ternary-priority-order"
+
+
 class PassToKernelStackTest(P4EbpfTest):
     p4_file_path = "p4testdata/pass-to-kernel.p4"
 
@@ -22,6 +22,7 @@ limitations under the License.
 #include "backends/p4test/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/frontendCache.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/evaluator/evaluator.h"
 #include "frontends/p4/frontend.h"
@@ -164,27 +165,37 @@ int main(int argc, char *const argv[]) {
             error(ErrorType::ERR_IO, "Can't open %s", options.file);
         }
     } else {
-        P4::DiagnosticCountInfo info;
-        program = P4::parseP4File(options);
-        info.emitInfo("PARSER");
-
-        if (program != nullptr && ::P4::errorCount() == 0) {
+        std::optional<P4::FrontendCache> cache;
+        if (!options.parseOnly) cache = P4::FrontendCache::open(options);
+        if (cache && (program = cache->load())) {
             P4TestPragmas testPragmas;
             program->apply(P4::ApplyOptionsPragmas(testPragmas));
-            info.emitInfo("PASS P4COptionPragmaParser");
-
-            if (!options.parseOnly) {
-                try {
-                    TestFEPolicy fe_policy(testPragmas);
-                    P4::FrontEnd fe(&fe_policy);
-                    fe.addDebugHook(hook);
-                    // use -TdiagnosticCountInPass:1 / -TdiagnosticCountInPass:4 to get output of
-                    // this hook
-                    fe.addDebugHook(info.getPassManagerHook());
-                    program = fe.run(options, program);
-                } catch (const std::exception &bug) {
-                    std::cerr << bug.what() << std::endl;
-                    return 1;
+        } else {
+            P4::DiagnosticCountInfo info;
+            if (cache) cache->record();
+            program = cache ? cache->parse(options) : P4::parseP4File(options);
+            info.emitInfo("PARSER");
+
+            if (program != nullptr && ::P4::errorCount() == 0) {
+                P4TestPragmas testPragmas;
+                program->apply(P4::ApplyOptionsPragmas(testPragmas));
+                info.emitInfo("PASS P4COptionPragmaParser");
+
+                if (!options.parseOnly) {
+                    try {
+                        TestFEPolicy fe_policy(testPragmas);
+                        P4::FrontEnd fe(&fe_policy);
+                        fe.addDebugHook(hook);
+                        // use -TdiagnosticCountInPass:1 / -TdiagnosticCountInPass:4 to get output
+                        // of this hook
+                        fe.addDebugHook(info.getPassManagerHook());
+                        program = fe.run(options, program);
+                    } catch (const std::exception &bug) {
+                        std::cerr << bug.what() << std::endl;
+                        return 1;
+                    }
+                    if (cache && program != nullptr && ::P4::errorCount() == 0)
+                        cache->store(program);
                 }
             }
         }
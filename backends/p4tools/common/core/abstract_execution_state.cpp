@@ -16,6 +16,8 @@ AbstractExecutionState::AbstractExecutionState(const IR::P4Program *program)
 
 AbstractExecutionState::AbstractExecutionState() : namespaces(NamespaceContext::Empty) {}
 
+void AbstractExecutionState::freeze() { env.freeze(); }
+
 /* =============================================================================================
  *  Accessors
  * ============================================================================================= */
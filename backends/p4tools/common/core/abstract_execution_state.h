@@ -40,6 +40,11 @@ class AbstractExecutionState {
     /// Returns a reference, not a pointer.
     [[nodiscard]] virtual AbstractExecutionState &clone() const = 0;
 
+    /// Prepares this state for being cloned several times, e.g., before it forks into multiple
+    /// branches: the contents of the state are frozen, so that subsequent clones share them with
+    /// this state instead of copying them. Cloning a const state never modifies it.
+    virtual void freeze();
+
     AbstractExecutionState(AbstractExecutionState &&) = default;
 
     /* =========================================================================================
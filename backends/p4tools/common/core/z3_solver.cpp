@@ -5,6 +5,7 @@
 #include <exception>
 #include <iterator>
 #include <map>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -39,7 +40,7 @@ const char *toString(z3::model m) { return Z3_model_to_string(m.ctx(), m); }
 #define Z3_LOG(...)
 #endif  // NDEBUG
 
-z3::sort Z3Solver::toSort(const IR::Type *type) {
+z3::sort Z3Solver::toSort(const IR::Type *type) const {
     BUG_CHECK(type, "Z3Solver::toSort with empty pointer");
 
     if (type->is<IR::Type_Boolean>()) {
@@ -63,15 +64,11 @@ std::string Z3Solver::generateName(const IR::SymbolicVariable &var) {
     return ostr.str();
 }
 
-z3::expr Z3Solver::declareVar(const IR::SymbolicVariable &var) {
+z3::expr Z3Solver::declareVar(const IR::SymbolicVariable &var,
+                              Z3DeclaredVariablesMap::value_type &declaredVars) const {
     auto sort = toSort(var.type);
     auto expr = ctx().constant(generateName(var).c_str(), sort);
-    BUG_CHECK(
-        !declaredVarsById.empty(),
-        "DeclaredVarsById should have at least one entry! Check if push() was used correctly.");
-    // Need to take the reference here to avoid accidental copies.
-    auto *latestVars = &declaredVarsById.back();
-    latestVars->emplace(expr.id(), &var);
+    declaredVars.emplace(expr.id(), &var);
     return expr;
 }
 
@@ -174,16 +171,102 @@ std::optional<bool> Z3Solver::interpretSolverResult(z3::check_result result) {
 
 std::optional<bool> Z3Solver::checkSat() {
     Util::ScopedTimer ctCheckSat("checkSat");
+    pendingModelQuery.reset();
+    pendingModel = nullptr;
     return interpretSolverResult(z3solver.check());
 }
 
 std::optional<bool> Z3Solver::checkSat(const z3::expr_vector &asserts) {
     Util::ScopedTimer ctCheckSat("checkSat");
+    pendingModelQuery.reset();
+    pendingModel = nullptr;
     return interpretSolverResult(z3solver.check(asserts));
 }
 
+namespace {
+
+/// Collects the labels of the symbolic variables in an expression.
+class SymbolicVariableCollector : public Inspector {
+    std::set<cstring> &labels;
+
+ public:
+    explicit SymbolicVariableCollector(std::set<cstring> &labels) : labels(labels) {}
+
+    bool preorder(const IR::SymbolicVariable *var) override {
+        labels.insert(var->label);
+        return false;
+    }
+};
+
+}  // namespace
+
+Z3Solver::CanonicalQuery Z3Solver::canonicalize(
+    std::vector<const Constraint *>::const_iterator begin,
+    std::vector<const Constraint *>::const_iterator end) {
+    CanonicalQuery query(begin, end);
+    std::sort(query.begin(), query.end());
+    query.erase(std::unique(query.begin(), query.end()), query.end());
+    return query;
+}
+
 std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &asserts) {
     Util::ScopedTimer ctZ3("z3");
+    pendingModelQuery.reset();
+    pendingModel = nullptr;
+    auto query = canonicalize(asserts.begin(), asserts.end());
+    if (auto it = queryCache.find(query); it != queryCache.end()) {
+        Z3_LOG("cached result for %d assertions", asserts.size());
+        if (it->second) {
+            pendingModelQuery = asserts;
+        }
+        return it->second;
+    }
+
+    std::optional<bool> result;
+    if (asserts.size() > 1) {
+        auto prefix = queryCache.find(canonicalize(asserts.begin(), asserts.end() - 1));
+        if (prefix != queryCache.end() && prefix->second) {
+            result = solveSlice(asserts);
+            if (result == true) {
+                pendingModelQuery = asserts;
+            }
+        }
+    }
+    if (!result.has_value()) {
+        result = solve(asserts);
+    }
+
+    if (result.has_value()) {
+        cacheResult(std::move(query), *result);
+    }
+    return result;
+}
+
+void Z3Solver::cacheResult(CanonicalQuery &&query, bool result) {
+    if (queryCache.size() >= QUERY_CACHE_LIMIT ||
+        queryCacheConstraints + query.size() > QUERY_CACHE_CONSTRAINT_LIMIT) {
+        queryCache.clear();
+        queryCacheConstraints = 0;
+    }
+    auto size = query.size();
+    if (queryCache.emplace(std::move(query), result).second) {
+        queryCacheConstraints += size;
+    }
+}
+
+void Z3Solver::configure(z3::solver &solver) const {
+    z3::params param(ctx());
+    if (seed_) {
+        param.set("phase_selection", 5U);
+        param.set("random_seed", *seed_);
+    }
+    if (timeout_) {
+        param.set(":timeout", *timeout_);
+    }
+    solver.set(param);
+}
+
+std::optional<bool> Z3Solver::solve(const std::vector<const Constraint *> &asserts) {
     if (isIncremental) {
         // Find common prefix with the previous invocation's list of assertions
         auto from = asserts.begin();
@@ -208,6 +291,57 @@ std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &as
     return isIncremental ? checkSat() : checkSat(z3Assertions);
 }
 
+std::optional<bool> Z3Solver::solveSlice(const std::vector<const Constraint *> &asserts) {
+    Util::ScopedTimer ctSlice("slice");
+    std::vector<std::set<cstring>> variables(asserts.size());
+    for (size_t i = 0; i < asserts.size(); ++i) {
+        SymbolicVariableCollector collector(variables[i]);
+        asserts[i]->apply(collector);
+    }
+
+    // Grow the slice from the last constraint until no other constraint shares a variable.
+    std::set<cstring> sliceVariables = variables.back();
+    std::vector<bool> inSlice(asserts.size(), false);
+    inSlice.back() = true;
+    size_t sliceSize = 1;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (size_t i = 0; i + 1 < asserts.size(); ++i) {
+            if (inSlice[i] || std::none_of(variables[i].begin(), variables[i].end(),
+                                           [&sliceVariables](cstring label) {
+                                               return sliceVariables.count(label) > 0;
+                                           })) {
+                continue;
+            }
+            inSlice[i] = true;
+            ++sliceSize;
+            sliceVariables.insert(variables[i].begin(), variables[i].end());
+            changed = true;
+        }
+    }
+    // Nothing to gain over the incremental solver, which already holds most of the query.
+    if (sliceSize == asserts.size()) {
+        return std::nullopt;
+    }
+
+    Z3_LOG("checking slice of %d out of %d assertions", sliceSize, asserts.size());
+    try {
+        z3::solver sliceSolver(ctx());
+        configure(sliceSolver);
+        // The slice has no model of interest, so its declarations are not kept.
+        Z3DeclaredVariablesMap::value_type sliceVars;
+        for (size_t i = 0; i < asserts.size(); ++i) {
+            if (inSlice[i]) {
+                Z3Translator z3translator(*this, sliceVars);
+                sliceSolver.add(z3translator.translate(asserts[i]));
+            }
+        }
+        return interpretSolverResult(sliceSolver.check());
+    } catch (z3::exception &e) {
+        BUG("Z3Solver: Z3 exception: %1%", e.msg());
+    }
+}
+
 void Z3Solver::asrt(const Constraint *assertion) {
     CHECK_NULL(assertion);
     Z3Translator z3translator(*this);
@@ -233,7 +367,14 @@ void Z3Solver::asrt(const z3::expr &assertion) {
 
 const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
     Util::ScopedTimer ctZ3("z3");
-    auto *result = new SymbolicMapping();
+    if (pendingModelQuery.has_value()) {
+        // The last query was answered from the cache or from a slice, so Z3 holds no model for
+        // it. Solve it separately, leaving the incremental solver untouched.
+        if (pendingModel == nullptr) {
+            pendingModel = &solvePendingModelQuery();
+        }
+        return *pendingModel;
+    }
     // First, collect a map of all the declared variables we have encountered in the stack.
     std::map<unsigned int, const IR::SymbolicVariable *> declaredVars;
     for (auto it = declaredVarsById.rbegin(); it != declaredVarsById.rend(); ++it) {
@@ -245,7 +386,42 @@ const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
     // Then, get the model and match each declaration in the model to its IR::SymbolicVariable.
     try {
         Util::ScopedTimer ctCheckSat("getModel");
-        auto z3Model = z3solver.get_model();
+        return toSymbolicMapping(z3solver.get_model(), declaredVars);
+    } catch (z3::exception &e) {
+        BUG("Z3Solver : Z3 exception: %1%", e.msg());
+    }
+}
+
+const SymbolicMapping &Z3Solver::solvePendingModelQuery() const {
+    Util::ScopedTimer ctModel("pendingModel");
+    try {
+        z3::solver modelSolver(ctx());
+        configure(modelSolver);
+        Z3DeclaredVariablesMap::value_type modelVars;
+        for (const auto *assertion : *pendingModelQuery) {
+            Z3Translator z3translator(*this, modelVars);
+            modelSolver.add(z3translator.translate(assertion));
+        }
+        Z3_LOG("solving cached query of %d assertions for its model", pendingModelQuery->size());
+        auto result = interpretSolverResult(modelSolver.check());
+        if (!result.has_value()) {
+            // Z3 gave up this time, e.g., because of the timeout. There is no model to report.
+            return *new SymbolicMapping();
+        }
+        BUG_CHECK(*result, "Z3Solver: query cached as satisfiable is unsatisfiable");
+        return toSymbolicMapping(modelSolver.get_model(),
+                                 std::map<unsigned int, const IR::SymbolicVariable *>(
+                                     modelVars.begin(), modelVars.end()));
+    } catch (z3::exception &e) {
+        BUG("Z3Solver : Z3 exception: %1%", e.msg());
+    }
+}
+
+const SymbolicMapping &Z3Solver::toSymbolicMapping(
+    const z3::model &z3Model,
+    const std::map<unsigned int, const IR::SymbolicVariable *> &declaredVars) {
+    auto *result = new SymbolicMapping();
+    try {
         Z3_LOG("z3 model:%s", toString(z3Model));
 
         // Loop through each declaration in the Z3 model and convert to the output model.
@@ -358,14 +534,31 @@ Z3Solver::Z3Solver(bool isIncremental, std::optional<std::istream *> inOpt)
     addZ3Pushes(chkIndex, assertions.size());
 }
 
-Z3Translator::Z3Translator(Z3Solver &solver) : result(solver.ctx()), solver(solver) {}
+namespace {
+
+/// @returns the variables declared in the innermost context of @param declaredVarsById.
+Z3DeclaredVariablesMap::value_type &currentDeclarations(Z3DeclaredVariablesMap &declaredVarsById) {
+    BUG_CHECK(
+        !declaredVarsById.empty(),
+        "DeclaredVarsById should have at least one entry! Check if push() was used correctly.");
+    return declaredVarsById.back();
+}
+
+}  // namespace
+
+Z3Translator::Z3Translator(Z3Solver &solver)
+    : Z3Translator(solver, currentDeclarations(solver.declaredVarsById)) {}
+
+Z3Translator::Z3Translator(const Z3Solver &solver,
+                           Z3DeclaredVariablesMap::value_type &declaredVars)
+    : result(solver.ctx()), solver(solver), declaredVars(declaredVars) {}
 
 bool Z3Translator::preorder(const IR::Node *node) {
     BUG("%1%: Unhandled node type: %2%", node, node->node_type_name());
 }
 
 bool Z3Translator::preorder(const IR::Cast *cast) {
-    Z3Translator tCast(solver);
+    Z3Translator tCast(solver, declaredVars);
     cast->expr->apply(tCast);
     uint64_t exprSize = 0;
     const auto *const castExtrType = cast->expr->type;
@@ -448,7 +641,7 @@ bool Z3Translator::preorder(const IR::StringLiteral *stringLiteral) {
 }
 
 bool Z3Translator::preorder(const IR::SymbolicVariable *var) {
-    result = solver.get().declareVar(*var);
+    result = solver.get().declareVar(*var, declaredVars);
     return false;
 }
 
@@ -484,7 +677,7 @@ const ShiftType *Z3Translator::rewriteShift(const ShiftType *shift) const {
 /// General function for unary operations.
 bool Z3Translator::recurseUnary(const IR::Operation_Unary *unary, Z3UnaryOp f) {
     BUG_CHECK(unary, "Z3Translator: encountered null node during translation");
-    Z3Translator tExpr(solver);
+    Z3Translator tExpr(solver, declaredVars);
     unary->expr->apply(tExpr);
     result = f(tExpr.result);
     return false;
@@ -569,8 +762,8 @@ bool Z3Translator::preorder(const IR::Concat *op) { return recurseBinary(op, z3:
 /// general function for binary operations
 bool Z3Translator::recurseBinary(const IR::Operation_Binary *binary, Z3BinaryOp f) {
     BUG_CHECK(binary, "Z3Translator: encountered null node during translation");
-    Z3Translator tLeft(solver);
-    Z3Translator tRight(solver);
+    Z3Translator tLeft(solver, declaredVars);
+    Z3Translator tRight(solver, declaredVars);
     binary->left->apply(tLeft);
     binary->right->apply(tRight);
     result = f(tLeft.result, tRight.result);
@@ -589,9 +782,9 @@ bool Z3Translator::preorder(const IR::Slice *op) {
 /// general function for ternary operations
 bool Z3Translator::recurseTernary(const IR::Operation_Ternary *ternary, Z3TernaryOp f) {
     BUG_CHECK(ternary, "Z3Translator: encountered null node during translation");
-    Z3Translator t0(solver);
-    Z3Translator t1(solver);
-    Z3Translator t2(solver);
+    Z3Translator t0(solver, declaredVars);
+    Z3Translator t1(solver, declaredVars);
+    Z3Translator t2(solver, declaredVars);
     ternary->e0->apply(t0);
     ternary->e1->apply(t1);
     ternary->e2->apply(t2);
@@ -8,12 +8,14 @@
 #include <iosfwd>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "ir/ir.h"
 #include "ir/json_generator.h"
 #include "ir/solver.h"
 #include "lib/cstring.h"
+#include "lib/hash.h"
 #include "lib/ordered_map.h"
 #include "lib/rtti.h"
 #include "lib/safe_vector.h"
@@ -26,6 +28,12 @@ namespace P4::P4Tools {
 using Z3DeclaredVariablesMap = std::vector<ordered_map<unsigned, const IR::SymbolicVariable *>>;
 
 /// A Z3-based implementation of AbstractSolver. Encapsulates a z3::solver and a z3::context.
+///
+/// Queries made through checkSat(const std::vector<const Constraint *> &) are first looked up in
+/// a cache of earlier results. When all constraints of a query but the last are known to be
+/// satisfiable, only the constraints that share variables with the last one are sent to Z3.
+/// In both cases, the model is computed from the full query, on a separate Z3 solver, once it is
+/// requested.
 class Z3Solver : public AbstractSolver {
     friend class Z3Translator;
     friend class Z3JSON;
@@ -90,15 +98,16 @@ class Z3Solver : public AbstractSolver {
 
  private:
     /// Converts a P4 type to a Z3 sort.
-    z3::sort toSort(const IR::Type *type);
+    z3::sort toSort(const IR::Type *type) const;
 
     /// Get the actual Z3 context that this class uses. This context can be manipulated.
     [[nodiscard]] z3::context &ctx() const;
 
-    /// Declares the given symbolic variable to Z3.
+    /// Declares the given symbolic variable to Z3 and records it in @param declaredVars.
     ///
     /// @returns the resulting Z3 variable.
-    z3::expr declareVar(const IR::SymbolicVariable &var);
+    z3::expr declareVar(const IR::SymbolicVariable &var,
+                        Z3DeclaredVariablesMap::value_type &declaredVars) const;
 
     /// Generates a Z3 name for the given symbolic variable.
     [[nodiscard]] static std::string generateName(const IR::SymbolicVariable &var);
@@ -117,6 +126,67 @@ class Z3Solver : public AbstractSolver {
     /// Helper function which converts a z3::check_result to a std::optional<bool>.
     static std::optional<bool> interpretSolverResult(z3::check_result result);
 
+    /// A query in canonical form: its constraints sorted by address, without duplicates.
+    using CanonicalQuery = std::vector<const Constraint *>;
+
+    struct CanonicalQueryHash {
+        size_t operator()(const CanonicalQuery &query) const {
+            return Util::hash(query.data(), query.size() * sizeof(const Constraint *));
+        }
+    };
+
+    /// @returns the canonical form of the constraints in [@param begin, @param end).
+    static CanonicalQuery canonicalize(std::vector<const Constraint *>::const_iterator begin,
+                                       std::vector<const Constraint *>::const_iterator end);
+
+    /// Asserts @param asserts to the Z3 solver, reusing the assertions shared with the previous
+    /// invocation, and checks their satisfiability.
+    std::optional<bool> solve(const std::vector<const Constraint *> &asserts);
+
+    /// Applies the seed and timeout of this solver to @param solver.
+    void configure(z3::solver &solver) const;
+
+    /// Solves @ref pendingModelQuery on a separate Z3 solver and converts its model.
+    ///
+    /// @returns an empty mapping if Z3 gives up on the query.
+    [[nodiscard]] const SymbolicMapping &solvePendingModelQuery() const;
+
+    /// Converts @param z3Model, whose variables are declared in @param declaredVars.
+    [[nodiscard]] static const SymbolicMapping &toSymbolicMapping(
+        const z3::model &z3Model,
+        const std::map<unsigned int, const IR::SymbolicVariable *> &declaredVars);
+
+    /// Checks @param asserts, of which all constraints but the last are known to be satisfiable.
+    /// Only the constraints that share variables with the last constraint, directly or through
+    /// other constraints, are checked, on a separate Z3 solver.
+    ///
+    /// @returns std::nullopt if the query can not be sliced or Z3 gives up on the slice.
+    std::optional<bool> solveSlice(const std::vector<const Constraint *> &asserts);
+
+    /// Adds the result of @param query to @ref queryCache.
+    void cacheResult(CanonicalQuery &&query, bool result);
+
+    /// Results of earlier queries. Unknown results are not cached.
+    std::unordered_map<CanonicalQuery, bool, CanonicalQueryHash> queryCache;
+
+    /// Total number of constraints held by the queries in @ref queryCache.
+    size_t queryCacheConstraints = 0;
+
+    /// Number of entries after which @ref queryCache is cleared.
+    static constexpr size_t QUERY_CACHE_LIMIT = 1 << 16;
+
+    /// Number of constraints, across all queries, after which @ref queryCache is cleared. This
+    /// bounds the memory held by the cache to a few tens of megabytes, however long the queries.
+    static constexpr size_t QUERY_CACHE_CONSTRAINT_LIMIT = 1 << 22;
+
+    /// The last satisfiable query, if it was answered without asserting it to @ref z3solver.
+    /// @ref getSymbolicMapping solves it on a separate solver before producing a model.
+    std::optional<std::vector<const Constraint *>> pendingModelQuery;
+
+    /// The model of @ref pendingModelQuery, computed lazily by @ref getSymbolicMapping.
+    /// Reset whenever @ref pendingModelQuery changes.
+    mutable const SymbolicMapping *pendingModel = nullptr;
+
     /// The underlying Z3 instance.
     z3::solver z3solver;
 
@@ -154,6 +224,10 @@ class Z3Translator : public virtual Inspector {
     /// the Z3 instance encapsulated within the given solver.
     explicit Z3Translator(Z3Solver &solver);
 
+    /// Creates a Z3 translator that records the variables it declares in @param declaredVars
+    /// rather than in the current context of @param solver.
+    Z3Translator(const Z3Solver &solver, Z3DeclaredVariablesMap::value_type &declaredVars);
+
     /// Handles unexpected nodes.
     bool preorder(const IR::Node *node) override;
 
@@ -242,7 +316,10 @@ class Z3Translator : public virtual Inspector {
     z3::expr result;
 
     /// The Z3 solver instance, to which variables will be declared as they are encountered.
-    std::reference_wrapper<Z3Solver> solver;
+    std::reference_wrapper<const Z3Solver> solver;
+
+    /// Where the declared variables are recorded.
+    std::reference_wrapper<Z3DeclaredVariablesMap::value_type> declaredVars;
 };
 
 }  // namespace P4::P4Tools
@@ -0,0 +1,59 @@
+#ifndef BACKENDS_P4TOOLS_COMMON_LIB_COPY_ON_WRITE_H_
+#define BACKENDS_P4TOOLS_COMMON_LIB_COPY_ON_WRITE_H_
+
+namespace P4::P4Tools {
+
+/// Holds a value of type T that can be shared between copies of the holder until one of them
+/// modifies it. A holder owns its value exclusively until @ref share is called on it; copies of
+/// an exclusive holder copy the value, copies of a shared holder are O(1) and refer to the same
+/// value. The first modification through any holder of a shared value then copies it. Copying
+/// never modifies the source holder, so a holder may be copied while it is read concurrently.
+/// Values are allocated with new and, like the execution states that hold them, are reclaimed by
+/// the garbage collector.
+template <typename T>
+class CopyOnWrite {
+    const T *value;
+
+    /// Whether no other holder may refer to @ref value.
+    bool exclusive = true;
+
+ public:
+    CopyOnWrite() : value(new T()) {}
+
+    CopyOnWrite(const CopyOnWrite &other)
+        : value(other.exclusive ? new T(*other.value) : other.value), exclusive(other.exclusive) {}
+
+    CopyOnWrite &operator=(const CopyOnWrite &other) {
+        if (this != &other) {
+            value = other.exclusive ? new T(*other.value) : other.value;
+            exclusive = other.exclusive;
+        }
+        return *this;
+    }
+
+    // No move operations: a moved-from holder would still refer to the value.
+    ~CopyOnWrite() = default;
+
+    /// Allows copies of this holder to share its value. Call this before copying the holder
+    /// several times, e.g., when an execution state forks.
+    void share() { exclusive = false; }
+
+    /// @returns whether the value may be shared with other holders.
+    [[nodiscard]] bool isShared() const { return !exclusive; }
+
+    const T &operator*() const { return *value; }
+    const T *operator->() const { return value; }
+
+    /// @returns a modifiable reference to the value, copying it first if it is shared.
+    T &mutate() {
+        if (!exclusive) {
+            value = new T(*value);
+            exclusive = true;
+        }
+        return const_cast<T &>(*value);
+    }
+};
+
+}  // namespace P4::P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_LIB_COPY_ON_WRITE_H_ */
@@ -1,7 +1,9 @@
 #include "backends/p4tools/common/lib/symbolic_env.h"
 
 #include <algorithm>
+#include <iterator>
 #include <utility>
+#include <vector>
 
 #include "backends/p4tools/common/lib/model.h"
 #include "ir/indexed_vector.h"
@@ -11,15 +13,56 @@
 
 namespace P4::P4Tools {
 
-const IR::Expression *SymbolicEnv::get(const IR::StateVariable &var) const {
-    auto it = map.find(var);
-    if (it != map.end()) {
+void SymbolicEnv::freeze() {
+    if (map.empty()) {
+        return;
+    }
+    size_t depth = frozen != nullptr ? frozen->depth + 1 : 1;
+    if (depth <= MAX_LAYERS) {
+        frozen = new Layer{std::move(map), frozen, depth};
+        map.clear();
+        return;
+    }
+    // Flatten the chain, applying the layers from the oldest to the newest.
+    std::vector<const Layer *> layers;
+    for (const auto *layer = frozen; layer != nullptr; layer = layer->parent) {
+        layers.push_back(layer);
+    }
+    SymbolicMapType flattened = layers.back()->map;
+    for (auto it = std::next(layers.rbegin()); it != layers.rend(); ++it) {
+        for (const auto &binding : (*it)->map) {
+            flattened[binding.first] = binding.second;
+        }
+    }
+    for (const auto &binding : map) {
+        flattened[binding.first] = binding.second;
+    }
+    frozen = new Layer{std::move(flattened), nullptr, 1};
+    map.clear();
+}
+
+size_t SymbolicEnv::getDepth() const { return frozen != nullptr ? frozen->depth : 0; }
+
+const IR::Expression *SymbolicEnv::find(const IR::StateVariable &var) const {
+    if (auto it = map.find(var); it != map.end()) {
         return it->second;
     }
+    for (const auto *layer = frozen; layer != nullptr; layer = layer->parent) {
+        if (auto it = layer->map.find(var); it != layer->map.end()) {
+            return it->second;
+        }
+    }
+    return nullptr;
+}
+
+const IR::Expression *SymbolicEnv::get(const IR::StateVariable &var) const {
+    if (const auto *value = find(var)) {
+        return value;
+    }
     BUG("Unable to find var %s in the symbolic environment.", var);
 }
 
-bool SymbolicEnv::exists(const IR::StateVariable &var) const { return map.find(var) != map.end(); }
+bool SymbolicEnv::exists(const IR::StateVariable &var) const { return find(var) != nullptr; }
 
 void SymbolicEnv::set(const IR::StateVariable &var, const IR::Expression *value) {
     BUG_CHECK(value->type && !value->type->is<IR::Type_Unknown>(),
@@ -63,7 +106,14 @@ const IR::Expression *SymbolicEnv::subst(const IR::Expression *expr) const {
     return expr->apply(SubstVisitor(*this));
 }
 
-const SymbolicMapType &SymbolicEnv::getInternalMap() const { return map; }
+SymbolicMapType SymbolicEnv::getInternalMap() const {
+    SymbolicMapType result = map;
+    for (const auto *layer = frozen; layer != nullptr; layer = layer->parent) {
+        // Bindings of newer layers shadow those of older ones, and insert does not overwrite.
+        result.insert(layer->map.begin(), layer->map.end());
+    }
+    return result;
+}
 
 bool SymbolicEnv::isSymbolicValue(const IR::Node *node) {
     // Check the obvious case first.
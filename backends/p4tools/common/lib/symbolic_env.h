@@ -9,13 +9,54 @@ namespace P4::P4Tools {
 
 /// A symbolic environment maps variables to their symbolic value. A symbolic value is just an
 /// expression on the program's initial state.
+///
+/// Copies of an environment share the bindings that were frozen (see @ref freeze) into a chain
+/// of immutable layers, and each environment only owns the bindings it made since. Copying is
+/// therefore proportional to the number of bindings made since the last freeze rather than to
+/// the size of the environment. The chain is flattened once it gets too deep, to bound lookup
+/// cost. Copying never modifies the source environment.
 class SymbolicEnv {
  private:
+    /// An immutable set of bindings that shadows the ones of @ref parent.
+    struct Layer {
+        SymbolicMapType map;
+        const Layer *parent;
+        /// The number of layers in the chain ending in this one.
+        size_t depth;
+    };
+
+    /// Maximum number of layers before the chain is flattened into a single one.
+    static constexpr size_t MAX_LAYERS = 8;
+
+    /// Bindings made before this environment was last frozen. May be shared with other
+    /// environments.
+    const Layer *frozen = nullptr;
+
+    /// Bindings made since this environment was last frozen.
     SymbolicMapType map;
 
+    /// @returns the value bound to @param var, or nullptr.
+    [[nodiscard]] const IR::Expression *find(const IR::StateVariable &var) const;
+
  public:
+    SymbolicEnv() = default;
+    SymbolicEnv(const SymbolicEnv &) = default;
+    SymbolicEnv &operator=(const SymbolicEnv &) = default;
+    SymbolicEnv(SymbolicEnv &&) = default;
+    SymbolicEnv &operator=(SymbolicEnv &&) = default;
+    ~SymbolicEnv() = default;
+
     // Maybe coerce from Model for concrete execution?
 
+    /// Moves the bindings made since the last freeze into a new shared layer, so that copies of
+    /// this environment do not copy them. This does not change the contents of the environment.
+    /// Call this before copying the environment several times, e.g., when an execution state
+    /// forks.
+    void freeze();
+
+    /// @returns the number of frozen layers of this environment.
+    [[nodiscard]] size_t getDepth() const;
+
     /// @returns the symbolic value for the given variable.
     [[nodiscard]] const IR::Expression *get(const IR::StateVariable &var) const;
 
@@ -30,8 +71,8 @@ class SymbolicEnv {
     /// Variables that are unbound by this environment are left untouched.
     const IR::Expression *subst(const IR::Expression *expr) const;
 
-    /// @returns The immutable map that is internal to this symbolic environment.
-    [[nodiscard]] const SymbolicMapType &getInternalMap() const;
+    /// @returns all bindings of this symbolic environment as a single map.
+    [[nodiscard]] SymbolicMapType getInternalMap() const;
 
     /// Determines whether the given node represents a symbolic value. Symbolic values may be
     /// stored in the symbolic environment.
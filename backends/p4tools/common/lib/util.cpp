@@ -27,7 +27,7 @@ namespace P4::P4Tools {
 
 std::optional<uint32_t> Utils::currentSeed = std::nullopt;
 
-boost::random::mt19937 Utils::rng(0);
+thread_local boost::random::mt19937 Utils::rng(0);
 
 std::string Utils::getTimeStamp() {
     // get current time
@@ -54,6 +54,8 @@ void Utils::setRandomSeed(int seed) {
     rng.seed(seed);
 }
 
+void Utils::setThreadRandomSeed(uint32_t seed) { rng.seed(seed); }
+
 std::optional<uint32_t> Utils::getCurrentSeed() { return currentSeed; }
 
 uint64_t Utils::getRandInt(uint64_t max) {
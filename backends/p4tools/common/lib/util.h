@@ -21,8 +21,9 @@ class Utils {
      *  Seeds, timestamps, randomness.
      * ========================================================================================= */
  private:
-    /// The random generator of this project. It is initialized with the input seed.
-    static boost::random::mt19937 rng;
+    /// The random generator of this project. It is initialized with the input seed. Each thread
+    /// has its own generator; see @ref setThreadRandomSeed.
+    static thread_local boost::random::mt19937 rng;
 
     /// Stores the state of the PRNG.
     static std::optional<uint32_t> currentSeed;
@@ -37,6 +38,10 @@ class Utils {
     /// Uses boost's mersenne twister.
     static void setRandomSeed(int seed);
 
+    /// Reseed the random generator of the calling thread only. @var currentSeed is unchanged.
+    /// Worker threads use this to derive their own deterministic sequence from the input seed.
+    static void setThreadRandomSeed(uint32_t seed);
+
     /// @returns currentSeed.
     static std::optional<uint32_t> getCurrentSeed();
 
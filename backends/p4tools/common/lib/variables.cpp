@@ -1,6 +1,7 @@
 #include "backends/p4tools/common/lib/variables.h"
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <tuple>
 
@@ -41,7 +42,9 @@ const IR::TaintExpression *getTaintExpression(const IR::Type *type) {
     // type.
     using key_t = std::tuple<int, bool>;
     static std::map<key_t, const IR::TaintExpression *> TAINTS;
+    static std::mutex TAINTS_LOCK;
 
+    std::lock_guard<std::mutex> guard(TAINTS_LOCK);
     auto *&result = TAINTS[{tb->width_bits(), tb->isSigned}];
     if (result == nullptr) {
         result = new IR::TaintExpression(type);
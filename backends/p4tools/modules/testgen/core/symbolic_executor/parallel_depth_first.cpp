@@ -0,0 +1,274 @@
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_depth_first.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/util.h"
+#include "ir/solver.h"
+#include "lib/error.h"
+#include "lib/gc.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/exceptions.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/options.h"
+
+#ifdef MULTITHREAD
+#include <thread>
+#endif
+
+namespace P4::P4Tools::P4Testgen {
+
+namespace {
+
+using Branch = SymbolicExecutor::Branch;
+
+/// The unexplored branches of one worker. The owner pushes and pops at the back, other workers
+/// steal from the front.
+class BranchDeque {
+    std::mutex lock;
+    std::deque<Branch> branches;
+
+ public:
+    void push(std::vector<Branch> &newBranches) {
+        std::lock_guard<std::mutex> guard(lock);
+        branches.insert(branches.end(), std::make_move_iterator(newBranches.begin()),
+                        std::make_move_iterator(newBranches.end()));
+    }
+
+    std::optional<Branch> pop() {
+        std::lock_guard<std::mutex> guard(lock);
+        if (branches.empty()) {
+            return std::nullopt;
+        }
+        std::optional<Branch> branch(std::move(branches.back()));
+        branches.pop_back();
+        return branch;
+    }
+
+    std::optional<Branch> steal() {
+        std::lock_guard<std::mutex> guard(lock);
+        if (branches.empty()) {
+            return std::nullopt;
+        }
+        std::optional<Branch> branch(std::move(branches.front()));
+        branches.pop_front();
+        return branch;
+    }
+};
+
+/// State shared by the workers of one run.
+struct Exploration {
+    explicit Exploration(unsigned workers) : deques(workers) {}
+
+    std::vector<BranchDeque> deques;
+
+    /// Number of branches in all deques. Branches are counted after they are pushed, so a thief
+    /// may briefly drive this below zero.
+    std::atomic<int64_t> available = 0;
+
+    /// Idle workers wait on @a wakeUp, under @a idleLock, for branches to become available.
+    /// Exploration is complete once all workers are idle: an idle worker's deque is empty and
+    /// only its owner pushes to it.
+    std::mutex idleLock;
+    std::condition_variable wakeUp;
+    std::atomic<unsigned> idle = 0;
+    bool done = false;
+
+    /// Set when the callback asks to terminate or a worker fails.
+    std::atomic<bool> stop = false;
+
+    /// Makes branches that were just pushed to a deque available to idle workers.
+    void added(size_t count) {
+        available += count;
+        // Sequentially consistent with the increment of @a idle by a worker about to wait, so
+        // either that worker sees the branches or this sees the worker.
+        if (idle > 0) {
+            std::lock_guard<std::mutex> guard(idleLock);
+            wakeUp.notify_all();
+        }
+    }
+
+    /// Ends the exploration early and wakes up all idle workers.
+    void terminate() {
+        stop = true;
+        std::lock_guard<std::mutex> guard(idleLock);
+        wakeUp.notify_all();
+    }
+
+    /// Serializes the callback.
+    std::mutex callbackLock;
+
+    /// The first exception thrown by a worker.
+    std::mutex errorLock;
+    std::exception_ptr error;
+};
+
+}  // namespace
+
+class ParallelDepthFirstSearch::Worker : public SymbolicExecutor {
+    Exploration &exploration;
+    unsigned index;
+
+    std::optional<Branch> steal() {
+        auto count = exploration.deques.size();
+        for (size_t i = 1; i < count; ++i) {
+            if (auto branch = exploration.deques[(index + i) % count].steal()) {
+                --exploration.available;
+                return branch;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Waits until branches may be available to steal. @returns false if the exploration is
+    /// over, either because it was stopped or because all workers are idle.
+    bool waitForWork() {
+        std::unique_lock<std::mutex> lock(exploration.idleLock);
+        if (++exploration.idle == exploration.deques.size()) {
+            exploration.done = true;
+            exploration.wakeUp.notify_all();
+            return false;
+        }
+        exploration.wakeUp.wait(lock, [this] {
+            return exploration.done || exploration.stop || exploration.available > 0;
+        });
+        if (exploration.done || exploration.stop) {
+            return false;
+        }
+        --exploration.idle;
+        return true;
+    }
+
+ public:
+    Worker(AbstractSolver &solver, const ProgramInfo &programInfo, Exploration &exploration,
+           unsigned index)
+        : SymbolicExecutor(solver, programInfo), exploration(exploration), index(index) {}
+
+    /// Explores depth-first from @param executionState until this worker runs out of branches.
+    void runImpl(const Callback &callBack, ExecutionStateReference executionState) override {
+        auto &unexploredBranches = exploration.deques[index];
+        while (!exploration.stop) {
+            try {
+                if (executionState.get().isTerminal()) {
+                    if (handleTerminalState(callBack, executionState)) {
+                        exploration.terminate();
+                        return;
+                    }
+                } else {
+                    StepResult successors = step(executionState);
+                    if (!successors->empty()) {
+                        // Pick a successor branch at random and leave the others to this worker's
+                        // stack, where they can be stolen.
+                        auto nextState = popRandomBranch(*successors).nextState;
+                        auto count = successors->size();
+                        unexploredBranches.push(*successors);
+                        exploration.added(count);
+                        executionState = nextState;
+                        continue;
+                    }
+                }
+            } catch (TestgenUnimplemented &e) {
+                // If strict is enabled, bubble the exception up.
+                if (TestgenOptions::get().strict) {
+                    throw;
+                }
+                warning("Path encountered unimplemented feature. Message: %1%\n", e.what());
+            }
+
+            auto branch = unexploredBranches.pop();
+            if (!branch.has_value()) {
+                return;
+            }
+            --exploration.available;
+            executionState = branch->nextState;
+        }
+    }
+
+    /// Explores from @param initialState, if any, then steals branches from other workers until
+    /// the exploration is complete.
+    void explore(const Callback &callBack, std::optional<ExecutionStateReference> initialState) {
+        if (initialState.has_value()) {
+            runImpl(callBack, *initialState);
+        }
+        while (!exploration.stop) {
+            if (auto branch = steal()) {
+                runImpl(callBack, branch->nextState);
+            } else if (!waitForWork()) {
+                return;
+            }
+        }
+    }
+};
+
+ParallelDepthFirstSearch::ParallelDepthFirstSearch(AbstractSolver &solver,
+                                                   const ProgramInfo &programInfo,
+                                                   unsigned workers)
+    : SymbolicExecutor(solver, programInfo), workers(workers) {
+#ifndef MULTITHREAD
+    this->workers = 1;
+#endif
+}
+
+void ParallelDepthFirstSearch::runImpl(const Callback &callBack,
+                                       ExecutionStateReference executionState) {
+    Exploration exploration(workers);
+    Callback serializedCallBack = [&exploration, &callBack](const FinalState &finalState) {
+        std::lock_guard<std::mutex> guard(exploration.callbackLock);
+        // Another worker may have ended the run while this one was computing its model.
+        if (exploration.stop) {
+            return true;
+        }
+        return callBack(finalState);
+    };
+    auto runWorker = [this, &exploration, &serializedCallBack](
+                         AbstractSolver &workerSolver, unsigned index,
+                         std::optional<ExecutionStateReference> initialState) {
+        try {
+            Worker(workerSolver, programInfo, exploration, index)
+                .explore(serializedCallBack, initialState);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(exploration.errorLock);
+            if (!exploration.error) {
+                exploration.error = std::current_exception();
+            }
+            exploration.terminate();
+        }
+    };
+
+#ifdef MULTITHREAD
+    std::vector<std::thread> threads;
+    for (unsigned index = 1; index < workers; ++index) {
+        threads.emplace_back([&runWorker, index] {
+            GCThreadRegistration registration;
+            ThreadLocalAllocCache allocCache;
+            // Give each worker its own, deterministic random sequence.
+            if (auto seed = Utils::getCurrentSeed()) {
+                Utils::setThreadRandomSeed(*seed + index);
+            }
+            Z3Solver workerSolver;
+            runWorker(workerSolver, index, std::nullopt);
+        });
+    }
+#endif
+    // The calling thread is the first worker and uses the executor's solver.
+    runWorker(solver, 0, executionState);
+#ifdef MULTITHREAD
+    for (auto &thread : threads) {
+        thread.join();
+    }
+#endif
+    if (exploration.error) {
+        std::rethrow_exception(exploration.error);
+    }
+}
+
+}  // namespace P4::P4Tools::P4Testgen
@@ -0,0 +1,38 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_
+
+#include "ir/solver.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+
+namespace P4::P4Tools::P4Testgen {
+
+/// A depth-first traversal strategy that explores the execution tree with several worker
+/// threads. Each worker owns a Z3 solver and a stack of unexplored branches, which it explores
+/// like DepthFirstSearch. A worker that runs out of branches steals the oldest unexplored branch
+/// of another worker, i.e., the one closest to the root and thus likely the largest subtree.
+///
+/// Terminal states are checked and modelled by the worker that reached them; the callback itself
+/// is serialized, so test back ends need not be thread-safe. The set of visited nodes is the one
+/// of this executor and is therefore shared by all workers.
+///
+/// Requires a MULTITHREAD build; otherwise the exploration runs on the calling thread only.
+class ParallelDepthFirstSearch : public SymbolicExecutor {
+ public:
+    void runImpl(const Callback &callBack, ExecutionStateReference executionState) override;
+
+    /// @param workers is the number of worker threads.
+    ParallelDepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo,
+                             unsigned workers);
+
+ private:
+    class Worker;
+
+    /// Number of worker threads.
+    unsigned workers;
+};
+
+}  // namespace P4::P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_ */
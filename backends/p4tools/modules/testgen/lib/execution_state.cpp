@@ -100,6 +100,21 @@ ExecutionState &ExecutionState::create(const IR::P4Program *program) {
 
 ExecutionState &ExecutionState::clone() const { return *new ExecutionState(*this); }
 
+ExecutionState &ExecutionState::clone() {
+    freeze();
+    return *new ExecutionState(*this);
+}
+
+void ExecutionState::freeze() {
+    AbstractExecutionState::freeze();
+    trace.share();
+    visitedNodes.share();
+    stateProperties.share();
+    testObjects.share();
+    pathConstraint.share();
+    selectedBranches.share();
+}
+
 /* =============================================================================================
  *  Accessors
  * ============================================================================================= */
@@ -107,11 +122,11 @@ ExecutionState &ExecutionState::clone() const { return *new ExecutionState(*this
 bool ExecutionState::isTerminal() const { return body.empty() && stack.empty(); }
 
 const std::vector<uint64_t> &ExecutionState::getSelectedBranches() const {
-    return selectedBranches;
+    return *selectedBranches;
 }
 
 const std::vector<const IR::Expression *> &ExecutionState::getPathConstraint() const {
-    return pathConstraint;
+    return *pathConstraint;
 }
 
 std::optional<const Continuation::Command> ExecutionState::getNextCmd() const {
@@ -173,10 +188,13 @@ void ExecutionState::markVisited(const IR::Node *node) {
     if (node->is<IR::P4Action>() && !coverageOptions.coverActions) {
         return;
     }
-    visitedNodes.emplace(node);
+    // Most nodes are visited many times; only copy a shared set if the node is new.
+    if (visitedNodes->count(node) == 0) {
+        visitedNodes.mutate().emplace(node);
+    }
 }
 
-const P4::Coverage::CoverageSet &ExecutionState::getVisited() const { return visitedNodes; }
+const P4::Coverage::CoverageSet &ExecutionState::getVisited() const { return *visitedNodes; }
 
 /// Compare types, considering Extracted_Varbit and bits equal if the (real/extracted) sizes are
 /// equal. This is because the packet expression can be something like 0 ++
@@ -214,7 +232,7 @@ void ExecutionState::set(const IR::StateVariable &var, const IR::Expression *val
 }
 
 const std::vector<std::reference_wrapper<const TraceEvent>> &ExecutionState::getTrace() const {
-    return trace;
+    return *trace;
 }
 
 const Continuation::Body &ExecutionState::getBody() const { return body; }
@@ -225,16 +243,16 @@ ExecutionState::getStack() const {
 }
 
 void ExecutionState::setProperty(cstring propertyName, Continuation::PropertyValue property) {
-    stateProperties[propertyName] = property;
+    stateProperties.mutate()[propertyName] = property;
 }
 
 bool ExecutionState::hasProperty(cstring propertyName) const {
-    return stateProperties.count(propertyName) > 0;
+    return stateProperties->count(propertyName) > 0;
 }
 
 void ExecutionState::addTestObject(cstring category, cstring objectLabel,
                                    const TestObject *object) {
-    testObjects[category][objectLabel] = object;
+    testObjects.mutate()[category][objectLabel] = object;
 }
 
 const TestObject *ExecutionState::getTestObject(cstring category, cstring objectLabel,
@@ -252,21 +270,24 @@ const TestObject *ExecutionState::getTestObject(cstring category, cstring object
 }
 
 TestObjectMap ExecutionState::getTestObjectCategory(cstring category) const {
-    auto it = testObjects.find(category);
-    if (it != testObjects.end()) {
+    auto it = testObjects->find(category);
+    if (it != testObjects->end()) {
         return it->second;
     }
     return {};
 }
 
 void ExecutionState::deleteTestObject(cstring category, cstring objectLabel) {
-    auto it = testObjects.find(category);
-    if (it != testObjects.end()) {
+    auto &objects = testObjects.mutate();
+    auto it = objects.find(category);
+    if (it != objects.end()) {
         it->second.erase(objectLabel);
     }
 }
 
-void ExecutionState::deleteTestObjectCategory(cstring category) { testObjects.erase(category); }
+void ExecutionState::deleteTestObjectCategory(cstring category) {
+    testObjects.mutate().erase(category);
+}
 
 void ExecutionState::setReachabilityEngineState(ReachabilityEngineState *newEngineState) {
     reachabilityEngineState = newEngineState;
@@ -280,7 +301,7 @@ ReachabilityEngineState *ExecutionState::getReachabilityEngineState() const {
  *  Trace events.
  * ============================================================================================= */
 
-void ExecutionState::add(const TraceEvent &event) { trace.emplace_back(event); }
+void ExecutionState::add(const TraceEvent &event) { trace.mutate().emplace_back(event); }
 
 void ExecutionState::popBody() { body.pop(); }
 
@@ -362,9 +383,13 @@ void ExecutionState::replaceTopBody(std::initializer_list<Continuation::Command>
  *  Packet manipulation
  * ============================================================================================= */
 
-void ExecutionState::pushPathConstraint(const IR::Expression *e) { pathConstraint.push_back(e); }
+void ExecutionState::pushPathConstraint(const IR::Expression *e) {
+    pathConstraint.mutate().push_back(e);
+}
 
-void ExecutionState::pushBranchDecision(uint64_t bIdx) { selectedBranches.push_back(bIdx); }
+void ExecutionState::pushBranchDecision(uint64_t bIdx) {
+    selectedBranches.mutate().push_back(bIdx);
+}
 
 const IR::SymbolicVariable *ExecutionState::getInputPacketSizeVar() {
     return ToolsVariables::getSymbolicVariable(&PacketVars::PACKET_SIZE_VAR_TYPE,
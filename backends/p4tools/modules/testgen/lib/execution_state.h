@@ -14,6 +14,7 @@
 
 #include "backends/p4tools/common/compiler/reachability.h"
 #include "backends/p4tools/common/core/abstract_execution_state.h"
+#include "backends/p4tools/common/lib/copy_on_write.h"
 #include "backends/p4tools/common/lib/namespace_context.h"
 #include "backends/p4tools/common/lib/symbolic_env.h"
 #include "backends/p4tools/common/lib/trace_event.h"
@@ -66,17 +67,19 @@ class ExecutionState : public AbstractExecutionState {
         [[nodiscard]] const NamespaceContext *getNameSpaces() const;
     };
 
-    /// No move semantics because of constant members. We always need to clone a state.
+    /// No move semantics because of constant members. We always need to clone a state. Cloning
+    /// a frozen state is cheap: the symbolic environment and the containers below are shared
+    /// with the clone until either side modifies them.
     ExecutionState(ExecutionState &&) = delete;
     ExecutionState &operator=(ExecutionState &&) = delete;
     ~ExecutionState() override = default;
 
  private:
     /// The program trace for the current program point (i.e., how we got to the current state).
-    std::vector<std::reference_wrapper<const TraceEvent>> trace;
+    CopyOnWrite<std::vector<std::reference_wrapper<const TraceEvent>>> trace;
 
     /// Set of visited nodes. Used for code coverage.
-    P4::Coverage::CoverageSet visitedNodes;
+    CopyOnWrite<P4::Coverage::CoverageSet> visitedNodes;
 
     /// The remaining body of the current function being executed.
     ///
@@ -98,7 +101,7 @@ class ExecutionState : public AbstractExecutionState {
     /// written while this variable is active is tainted. This property must be unset manually to
     /// resume normal operation by setting the property "false". Usually, this is done directly
     /// after the tainted sequence of commands has been executed.
-    std::map<cstring, Continuation::PropertyValue> stateProperties;
+    CopyOnWrite<std::map<cstring, Continuation::PropertyValue>> stateProperties;
 
     // Test objects are classes of variables that influence the execution of test frameworks. They
     // are collected during interpreter execution and consumed by the respective test framework. For
@@ -106,7 +109,7 @@ class ExecutionState : public AbstractExecutionState {
     // which defines control plane match action entries. Once the interpreter has solved for the
     // variables used by these test objects and concretized the values, they can be used to generate
     // a test. Test objects are not constant because they may be manipulated by a target back end.
-    std::map<cstring, TestObjectMap> testObjects;
+    CopyOnWrite<std::map<cstring, TestObjectMap>> testObjects;
 
     /// The parserErrorLabel is set by the parser to indicate the variable corresponding to the
     /// parser error that is set by various built-in functions such as verify or extract.
@@ -120,10 +123,10 @@ class ExecutionState : public AbstractExecutionState {
 
     /// List of path constraints - expressions that must all evaluate to true to reach this
     /// execution state.
-    std::vector<const IR::Expression *> pathConstraint;
+    CopyOnWrite<std::vector<const IR::Expression *>> pathConstraint;
 
     /// List of branch decisions leading into this state.
-    std::vector<uint64_t> selectedBranches;
+    CopyOnWrite<std::vector<uint64_t>> selectedBranches;
 
     /// State that is needed to track reachability of nodes given a query.
     ReachabilityEngineState *reachabilityEngineState = nullptr;
@@ -195,8 +198,8 @@ class ExecutionState : public AbstractExecutionState {
     /// BUG, If the specified type does not match or the property is not found.
     template <class T>
     [[nodiscard]] T getProperty(cstring propertyName) const {
-        auto iterator = stateProperties.find(propertyName);
-        if (iterator != stateProperties.end()) {
+        auto iterator = stateProperties->find(propertyName);
+        if (iterator != stateProperties->end()) {
             auto val = iterator->second;
             try {
                 T resolvedVal = std::get<T>(val);
@@ -389,6 +392,13 @@ class ExecutionState : public AbstractExecutionState {
     /// Returns a reference, not a pointer.
     [[nodiscard]] ExecutionState &clone() const override;
 
+    /// Like the const overload, but freezes this state first, as it is forking: the clone then
+    /// shares the contents of this state, and each of them copies a container only when it
+    /// first modifies it.
+    [[nodiscard]] ExecutionState &clone();
+
+    void freeze() override;
+
     /// Create a new execution state object from the input program.
     /// Returns a reference not a pointer.
     [[nodiscard]] static ExecutionState &create(const IR::P4Program *program);
@@ -276,6 +276,33 @@ TestgenOptions::TestgenOptions()
         "DEPTH_FIRST, RANDOM_BACKTRACK, and GREEDY_STATEMENT_SEARCH. "
         "Defaults to DEPTH_FIRST.");
 
+    registerOption(
+        "--parallel-workers", "workers",
+        [this](const char *arg) {
+            try {
+                std::string argStr(arg);
+                size_t end = 0;
+                auto workers = std::stoll(argStr, &end);
+                if (end != argStr.size() || workers < 1) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                parallelWorkers = workers;
+            } catch (std::exception &) {
+                error("Invalid input value %1% for --parallel-workers. Expected positive integer.",
+                      arg);
+                return false;
+            }
+#ifndef MULTITHREAD
+            if (parallelWorkers > 1) {
+                error("--parallel-workers requires a compiler built with ENABLE_MULTITHREAD.");
+                return false;
+            }
+#endif
+            return true;
+        },
+        "[EXPERIMENTAL] Explore paths with this many threads, each with its own solver "
+        "[default: 1]. Only supported with the DEPTH_FIRST path selection policy.");
+
     registerOption(
         "--track-coverage", "coverageItem",
         [this](const char *arg) {
@@ -426,6 +453,12 @@ bool TestgenOptions::validateOptions() const {
               "--assert-min-coverage is meaningless.");
         return false;
     }
+    if (parallelWorkers > 1 &&
+        (pathSelectionPolicy != PathSelectionPolicy::DepthFirst || !selectedBranches.empty())) {
+        error(ErrorType::ERR_INVALID,
+              "--parallel-workers is only supported with the DEPTH_FIRST path selection policy.");
+        return false;
+    }
     return true;
 }
 
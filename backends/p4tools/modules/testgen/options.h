@@ -27,6 +27,9 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// Selects the path selection policy for test generation
     P4Testgen::PathSelectionPolicy pathSelectionPolicy = P4Testgen::PathSelectionPolicy::DepthFirst;
 
+    /// Number of threads exploring paths in parallel. Defaults to 1 (no parallel exploration).
+    unsigned parallelWorkers = 1;
+
     /// List of the supported stop metrics.
     static const std::set<cstring> SUPPORTED_STOP_METRICS;
 
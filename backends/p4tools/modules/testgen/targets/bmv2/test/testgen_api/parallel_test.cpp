@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "test/gtest/helpers.h"
+
+#include "backends/p4tools/modules/testgen/options.h"
+#include "backends/p4tools/modules/testgen/targets/bmv2/test/gtest_utils.h"
+#include "backends/p4tools/modules/testgen/testgen.h"
+
+namespace P4::P4Tools::Test {
+
+using namespace P4::literals;
+
+class P4TestgenParallelTest : public P4TestgenBmv2Test {};
+
+TEST_F(P4TestgenParallelTest, FindsTheSamePathsAsDepthFirst) {
+    std::stringstream streamTest;
+    streamTest << R"p4(
+header ethernet_t {
+    bit<48> dst_addr;
+    bit<48> src_addr;
+    bit<16> ether_type;
+}
+
+struct Headers {
+  ethernet_t eth_hdr;
+}
+
+struct Metadata {  }
+parser parse(packet_in pkt, out Headers hdr, inout Metadata m, inout standard_metadata_t sm) {
+  state start {
+      pkt.extract(hdr.eth_hdr);
+      transition accept;
+  }
+}
+control ingress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {
+      if (hdr.eth_hdr.dst_addr == 0xDEADDEADDEAD) {
+          hdr.eth_hdr.src_addr = 1;
+      }
+      if (hdr.eth_hdr.ether_type == 0xF00D) {
+          hdr.eth_hdr.src_addr = 2;
+      } else if (hdr.eth_hdr.ether_type == 0xBEEF) {
+          mark_to_drop(sm);
+      }
+      if (hdr.eth_hdr.src_addr == 0xBEEFBEEFBEEF) {
+          sm.egress_spec = 2;
+      }
+  }
+}
+control egress(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {}
+}
+control deparse(packet_out pkt, in Headers hdr) {
+  apply {
+    pkt.emit(hdr.eth_hdr);
+  }
+}
+control verifyChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+control computeChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+V1Switch(parse(), verifyChecksum(), ingress(), egress(), computeChecksum(), deparse()) main;
+)p4";
+
+    auto source = P4_SOURCE(P4Headers::V1MODEL, streamTest.str().c_str());
+    auto &testgenOptions = P4Testgen::TestgenOptions::get();
+    testgenOptions.target = "bmv2"_cs;
+    testgenOptions.arch = "v1model"_cs;
+    testgenOptions.testBackend = "PROTOBUF_IR"_cs;
+    testgenOptions.testBaseName = "dummy"_cs;
+    testgenOptions.seed = 1;
+    testgenOptions.maxTests = 0;
+    // Create a bespoke packet for the Ethernet extract call.
+    testgenOptions.minPktSize = 112;
+    testgenOptions.maxPktSize = 112;
+
+    testgenOptions.parallelWorkers = 1;
+    auto depthFirst = P4Testgen::Testgen::generateTests(source, testgenOptions);
+    ASSERT_TRUE(depthFirst.has_value());
+    ASSERT_GT(depthFirst.value().size(), 1);
+
+    // Without MULTITHREAD, the parallel strategy runs its single worker on this thread.
+    testgenOptions.parallelWorkers = 4;
+    auto parallel = P4Testgen::Testgen::generateTests(source, testgenOptions);
+    testgenOptions.parallelWorkers = 1;
+    ASSERT_TRUE(parallel.has_value());
+    EXPECT_EQ(parallel.value().size(), depthFirst.value().size());
+}
+
+}  // namespace P4::P4Tools::Test
@@ -0,0 +1,65 @@
+#include "backends/p4tools/common/lib/copy_on_write.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "backends/p4tools/modules/testgen/test/lib/copy_on_write.h"
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using Holder = CopyOnWrite<std::vector<int>>;
+
+/// Copies of an exclusive holder get their own value, and copying does not change the source.
+TEST_F(CopyOnWriteTest, CopyExclusive) {
+    Holder original;
+    original.mutate().push_back(1);
+    const auto *value = &*original;
+
+    Holder copy(original);
+    EXPECT_FALSE(original.isShared());
+    EXPECT_FALSE(copy.isShared());
+    EXPECT_NE(&*copy, value);
+    EXPECT_EQ(*copy, std::vector<int>({1}));
+
+    // Modifying either holder does not affect the other.
+    copy.mutate().push_back(2);
+    original.mutate().push_back(3);
+    EXPECT_EQ(&*original, value);
+    EXPECT_EQ(*original, std::vector<int>({1, 3}));
+    EXPECT_EQ(*copy, std::vector<int>({1, 2}));
+}
+
+/// Copies of a shared holder share its value until one of them modifies it.
+TEST_F(CopyOnWriteTest, CopyShared) {
+    Holder original;
+    original.mutate().push_back(1);
+    original.share();
+    const auto *value = &*original;
+
+    Holder first(original);
+    Holder second;
+    second = original;
+    EXPECT_EQ(&*first, value);
+    EXPECT_EQ(&*second, value);
+    EXPECT_TRUE(first.isShared());
+
+    first.mutate().push_back(2);
+    EXPECT_FALSE(first.isShared());
+    EXPECT_NE(&*first, value);
+    EXPECT_EQ(*first, std::vector<int>({1, 2}));
+    EXPECT_EQ(*original, std::vector<int>({1}));
+    EXPECT_EQ(*second, std::vector<int>({1}));
+
+    // The original copies the shared value too before modifying it.
+    original.mutate().push_back(3);
+    EXPECT_NE(&*original, value);
+    EXPECT_EQ(*second, std::vector<int>({1}));
+    EXPECT_EQ(&*second, value);
+}
+
+}  // anonymous namespace
+
+}  // namespace P4::P4Tools::Test
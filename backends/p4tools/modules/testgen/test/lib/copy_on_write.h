@@ -0,0 +1,13 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_TEST_LIB_COPY_ON_WRITE_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_TEST_LIB_COPY_ON_WRITE_H_
+
+#include <gtest/gtest.h>
+
+namespace P4::P4Tools::Test {
+
+/// Helper methods to build configurations for CopyOnWrite Tests.
+class CopyOnWriteTest : public testing::Test {};
+
+}  // namespace P4::P4Tools::Test
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_TEST_LIB_COPY_ON_WRITE_H_ */
@@ -0,0 +1,83 @@
+#include "backends/p4tools/common/lib/symbolic_env.h"
+
+#include <gtest/gtest.h>
+
+#include "backends/p4tools/common/lib/variables.h"
+#include "backends/p4tools/modules/testgen/test/lib/symbolic_env.h"
+#include "ir/ir.h"
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using namespace P4::literals;
+
+const IR::Constant *value(int v) { return IR::Constant::get(IR::Type_Bits::get(8), v); }
+
+const IR::StateVariable &var(cstring name) {
+    return ToolsVariables::getStateVariable(IR::Type_Bits::get(8), name);
+}
+
+/// Bindings are visible through frozen layers, and newer bindings shadow older ones.
+TEST_F(SymbolicEnvTest, LayeredLookup) {
+    SymbolicEnv env;
+    env.set(var("a"_cs), value(1));
+    env.set(var("b"_cs), value(2));
+    env.freeze();
+    EXPECT_EQ(env.getDepth(), 1u);
+    env.set(var("b"_cs), value(3));
+    env.freeze();
+    env.set(var("c"_cs), value(4));
+    EXPECT_EQ(env.getDepth(), 2u);
+
+    EXPECT_TRUE(env.get(var("a"_cs))->equiv(*value(1)));
+    EXPECT_TRUE(env.get(var("b"_cs))->equiv(*value(3)));
+    EXPECT_TRUE(env.get(var("c"_cs))->equiv(*value(4)));
+    EXPECT_FALSE(env.exists(var("d"_cs)));
+
+    auto map = env.getInternalMap();
+    EXPECT_EQ(map.size(), 3u);
+    auto it = map.find(var("b"_cs));
+    ASSERT_NE(it, map.end());
+    EXPECT_TRUE(it->second->equiv(*value(3)));
+}
+
+/// Copies share frozen bindings, do not freeze the source, and diverge independently.
+TEST_F(SymbolicEnvTest, CopiesAreIndependent) {
+    SymbolicEnv env;
+    env.set(var("a"_cs), value(1));
+    SymbolicEnv unfrozenCopy(env);
+    EXPECT_EQ(env.getDepth(), 0u);
+    EXPECT_TRUE(unfrozenCopy.get(var("a"_cs))->equiv(*value(1)));
+
+    env.freeze();
+    SymbolicEnv copy(env);
+    EXPECT_EQ(copy.getDepth(), 1u);
+    copy.set(var("a"_cs), value(2));
+    env.set(var("b"_cs), value(3));
+
+    EXPECT_TRUE(env.get(var("a"_cs))->equiv(*value(1)));
+    EXPECT_TRUE(copy.get(var("a"_cs))->equiv(*value(2)));
+    EXPECT_FALSE(copy.exists(var("b"_cs)));
+    EXPECT_FALSE(unfrozenCopy.exists(var("b"_cs)));
+}
+
+/// Deep chains are flattened without changing the bindings.
+TEST_F(SymbolicEnvTest, Flatten) {
+    SymbolicEnv env;
+    for (int i = 0; i < 20; i++) {
+        env.set(var("a"_cs), value(i));
+        env.set(var(cstring("v" + std::to_string(i))), value(i));
+        env.freeze();
+        EXPECT_LE(env.getDepth(), 8u);
+    }
+    EXPECT_TRUE(env.get(var("a"_cs))->equiv(*value(19)));
+    for (int i = 0; i < 20; i++) {
+        EXPECT_TRUE(env.get(var(cstring("v" + std::to_string(i))))->equiv(*value(i)));
+    }
+    EXPECT_EQ(env.getInternalMap().size(), 21u);
+}
+
+}  // anonymous namespace
+
+}  // namespace P4::P4Tools::Test
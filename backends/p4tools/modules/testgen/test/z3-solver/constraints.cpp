@@ -189,4 +189,45 @@ TEST_F(Z3SolverSatisfiabilityChecks, Bools) {
     }
 }
 
+TEST(Z3SolverQueries, CachedAndSlicedQueries) {
+    P4Tools::Z3Solver solver;
+    const auto *eightBitType = IR::Type_Bits::get(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo"_cs);
+    const auto *barVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "bar"_cs);
+    const auto *bazVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "baz"_cs);
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::Constant::get(eightBitType, 1));
+    const auto *fooIsBar = new IR::Equ(fooVar, barVar);
+    const auto *bazIsTwo = new IR::Equ(bazVar, IR::Constant::get(eightBitType, 2));
+    const auto *barIsTwo = new IR::Equ(barVar, IR::Constant::get(eightBitType, 2));
+
+    ConstraintVector prefix = {fooIsOne, fooIsBar};
+    EXPECT_EQ(solver.checkSat(prefix), true);
+    // Reordered and repeated constraints form the same query.
+    ConstraintVector reordered = {fooIsBar, fooIsOne, fooIsBar};
+    EXPECT_EQ(solver.checkSat(reordered), true);
+
+    // Independent of the prefix, so only the last constraint is checked.
+    ConstraintVector independent = {fooIsOne, fooIsBar, bazIsTwo};
+    EXPECT_EQ(solver.checkSat(independent), true);
+    // The model still covers the whole query.
+    const auto &model = solver.getSymbolicMapping();
+    ASSERT_EQ(model.size(), 3U);
+    EXPECT_EQ(model.at(fooVar)->checkedTo<IR::Constant>()->asInt(), 1);
+    EXPECT_EQ(model.at(barVar)->checkedTo<IR::Constant>()->asInt(), 1);
+    EXPECT_EQ(model.at(bazVar)->checkedTo<IR::Constant>()->asInt(), 2);
+    // The model is computed once per query.
+    EXPECT_EQ(&solver.getSymbolicMapping(), &model);
+
+    // A cached query gets a model too, and computing it leaves the solver usable.
+    EXPECT_EQ(solver.checkSat(prefix), true);
+    const auto &prefixModel = solver.getSymbolicMapping();
+    ASSERT_EQ(prefixModel.size(), 2U);
+    EXPECT_EQ(prefixModel.at(barVar)->checkedTo<IR::Constant>()->asInt(), 1);
+
+    // Depends on the prefix through bar.
+    ConstraintVector dependent = {fooIsOne, fooIsBar, bazIsTwo, barIsTwo};
+    EXPECT_EQ(solver.checkSat(dependent), false);
+    EXPECT_EQ(solver.checkSat(dependent), false);
+}
+
 }  // namespace P4::P4Tools::Test
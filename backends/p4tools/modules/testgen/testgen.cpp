@@ -18,6 +18,7 @@
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/greedy_node_cov.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_depth_first.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/random_backtrack.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/selected_branches.h"
@@ -47,6 +48,9 @@ SymbolicExecutor *pickExecutionEngine(const TestgenOptions &testgenOptions,
         std::string selectedBranchesStr = testgenOptions.selectedBranches;
         return new SelectedBranches(solver, programInfo, selectedBranchesStr);
     }
+    if (testgenOptions.parallelWorkers > 1) {
+        return new ParallelDepthFirstSearch(solver, programInfo, testgenOptions.parallelWorkers);
+    }
     return new DepthFirstSearch(solver, programInfo);
 }
 
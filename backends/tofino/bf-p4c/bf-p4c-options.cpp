@@ -26,6 +26,7 @@
 #include <cstring>
 #include <set>
 #include <sstream>
+#include <stdexcept>
 #include <unordered_set>
 #include <vector>
 
@@ -60,6 +61,27 @@ static bool check_exclusive(bool option1, std::string option1Arg, bool option2,
     return true;
 }
 
+/// Parses @p arg, the argument of @p option, into @p value, which must be an integer of at
+/// least @p min.  Reports an error and @returns false otherwise.
+static bool parse_int_option(const char *option, const char *arg, int &value, int min) {
+    std::string argStr(arg);
+    try {
+        std::size_t end;
+        int tmp = std::stoi(argStr, &end);
+        if (end != argStr.size() || tmp < min) throw std::invalid_argument(argStr);
+        value = tmp;
+    } catch (...) {
+        if (min == 0)
+            ::error("Invalid %s value %s. Enter non-negative integer.", option, arg);
+        else if (min == 1)
+            ::error("Invalid %s value %s. Enter positive integer.", option, arg);
+        else
+            ::error("Invalid %s value %s. Enter integer of at least %d.", option, arg, min);
+        return false;
+    }
+    return true;
+}
+
 // vvv --- ANSI code --- vvv //
 
 const char *ANSI_CSI = "\033[";
@@ -524,6 +546,45 @@ BFN_Options::BFN_Options() {
         "Enable Metadata Initialization for alternative PHV allocation ordering(--alt-phv-alloc)",
         OptionFlags::Hide);
 #endif
+    registerOption(
+        "--phv-slicing-max-steps", "steps",
+        [this](const char *arg) {
+            return parse_int_option("--phv-slicing-max-steps", arg, phv_slicing_max_steps, 1);
+        },
+        "Stop searching for PHV slicings once all super clusters together took this many "
+        "steps. Super clusters not sliced by then use the best partial slicing found. "
+        "With --parallel-pipes, each pipe has a budget of its own");
+    registerOption(
+        "--phv-slicing-max-seconds", "seconds",
+        [this](const char *arg) {
+            return parse_int_option("--phv-slicing-max-seconds", arg, phv_slicing_max_seconds, 1);
+        },
+        "Stop searching for PHV slicings once all super clusters together took this many "
+        "seconds. Super clusters not sliced by then use the best partial slicing found. "
+        "With --parallel-pipes, each pipe has a budget of its own");
+    registerOption(
+        "--phv-slicing-cluster-max-steps", "steps",
+        [this](const char *arg) {
+            return parse_int_option("--phv-slicing-cluster-max-steps", arg,
+                                    phv_slicing_cluster_max_steps, 1);
+        },
+        "Maximum number of steps of the PHV slicing search on one super cluster. "
+        "Default: 33554432");
+    registerOption(
+        "--phv-slicing-cluster-max-seconds", "seconds",
+        [this](const char *arg) {
+            return parse_int_option("--phv-slicing-cluster-max-seconds", arg,
+                                    phv_slicing_cluster_max_seconds, 1);
+        },
+        "Maximum number of seconds of the PHV slicing search on one super cluster");
+    registerOption(
+        "--phv-alloc-workers", "workers",
+        [this](const char *arg) {
+            return parse_int_option("--phv-alloc-workers", arg, phv_alloc_workers, 0);
+        },
+        "Number of threads scoring PHV container groups, in compilers built with MULTITHREAD. "
+        "0 (the default) uses one per hardware thread, 1 scores them serially. "
+        "PHV allocation is serial whenever any logging is enabled");
     registerOption(
         "--traffic-limit", "arg",
         [this](const char *arg) {
@@ -562,6 +623,14 @@ BFN_Options::BFN_Options() {
             return true;
         },
         "Enable logging to Event Logger. Creates events.json in output folder.");
+    registerOption(
+        "--parallel-pipes", nullptr,
+        [this](const char *) {
+            parallel_pipes = true;
+            return true;
+        },
+        "Compile the pipes of a multi-pipe program concurrently, in one worker process per pipe.\n"
+        "Has no effect with --enable-event-logger.");
     registerOption(
         "--excludeBackendPasses", "pass1[,pass2]",
         [this](const char *arg) {
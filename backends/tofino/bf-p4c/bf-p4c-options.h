@@ -63,9 +63,19 @@ class BFN_Options : public CompilerOptions {
 #else
     bool alt_phv_alloc = false;
 #endif
+    /// Budgets of the PHV slicing search, for all super clusters together and for each of
+    /// them; 0 means the iterator default.
+    int phv_slicing_max_steps = 0;
+    int phv_slicing_max_seconds = 0;
+    int phv_slicing_cluster_max_steps = 0;
+    int phv_slicing_cluster_max_seconds = 0;
+    /// Threads scoring PHV container groups in MULTITHREAD builds; 0 means one per hardware
+    /// thread.
+    int phv_alloc_workers = 0;
     int traffic_limit = 100;
     int num_stages_override = 0;
     bool enable_event_logger = false;
+    bool parallel_pipes = false;
     bool disable_parse_min_depth_limit = false;
     bool disable_parse_max_depth_limit = false;
     bool alt_phv_alloc_meta_init = false;
@@ -146,7 +146,8 @@ void generateRuntime(const IR::P4Program *program, const BFN_Options &options) {
         program->apply(CheckReservedNames());
 
         LOG1("Populating BFRuntime Info for architecture " << arch << Log::indent);
-        auto p4Runtime = p4RuntimeSerializer->generateP4Runtime(program, arch);
+        // The BFRuntime schema only needs the P4Info.
+        auto p4Runtime = p4RuntimeSerializer->generateP4Runtime(program, arch, false);
         LOG1_UNINDENT;
 
         LOG1("Generating BFRuntime JSON for architecture " << arch << Log::indent);
@@ -53,6 +53,12 @@ class BfErrorReporter : public ErrorReporter {
 
     void increment_the_error_count() { ++this->errorCount; }
 
+    /// Adds the errors and warnings reported by a pipe worker process (--parallel-pipes).
+    void add_worker_counts(unsigned errors, unsigned warnings) {
+        this->errorCount += errors;
+        this->warningCount += warnings;
+    }
+
     /**
      * @brief Adds a check with no specified source code line.
      *
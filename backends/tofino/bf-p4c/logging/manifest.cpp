@@ -410,6 +410,42 @@ void Manifest::addLog(const int pipe, const cstring logType, const cstring logNa
     getPipeOutputs(pipe)->m_logs.insert(PathAndType(path, logType));
 }
 
+void Manifest::writePipeOutputs(std::ostream &out, const int pipe) {
+    const auto *outputs = getPipeOutputs(pipe);
+    if (outputs->m_context) out << "context " << pipe << " " << outputs->m_context << "\n";
+    for (const auto &[path, type] : outputs->m_resources)
+        out << "resource " << pipe << " " << type << " " << path << "\n";
+    for (const auto &[path, type] : outputs->m_logs)
+        out << "log " << pipe << " " << type << " " << path << "\n";
+    for (const auto &graph : outputs->m_graphs)
+        out << "graph " << pipe << " " << int(graph.m_gress) << " " << graph.m_type << " "
+            << graph.m_format << " " << graph.m_path << "\n";
+}
+
+void Manifest::readPipeOutputs(std::istream &in) {
+    std::string kind, type, format;
+    int pipe, gress;
+    while (in >> kind >> pipe) {
+        auto *outputs = getPipeOutputs(pipe);
+        if (kind == "graph") in >> gress >> type >> format;
+        if (kind == "resource" || kind == "log") in >> type;
+        std::string path;
+        std::getline(in >> std::ws, path);
+        if (kind == "context") {
+            outputs->m_context = cstring(path);
+        } else if (kind == "resource") {
+            outputs->m_resources.insert(PathAndType(cstring(path), cstring(type)));
+        } else if (kind == "log") {
+            outputs->m_logs.insert(PathAndType(cstring(path), cstring(type)));
+        } else if (kind == "graph") {
+            outputs->m_graphs.insert(
+                GraphOutput(cstring(path), gress_t(gress), cstring(type), cstring(format)));
+        } else {
+            BUG("Unexpected pipe output %1% in manifest", kind);
+        }
+    }
+}
+
 /// Return the singleton object
 Manifest &Manifest::getManifest() {
     static Manifest instance;
@@ -24,7 +24,9 @@
 
 #include <cstdarg>
 #include <fstream>
+#include <istream>
 #include <map>
+#include <ostream>
 #include <set>
 #include <string>
 #include <utility>
@@ -160,6 +162,11 @@ class Manifest : public Inspector {
     /// serialize the entire manifest
     virtual void serialize();
 
+    /// Write the outputs recorded for @p pipe in a line-based format that readPipeOutputs
+    /// merges back. Used by --parallel-pipes, which compiles each pipe in a worker process.
+    void writePipeOutputs(std::ostream &out, int pipe);
+    void readPipeOutputs(std::istream &in);
+
  private:
     void serialize_target_data(Writer &);
 
@@ -1378,6 +1378,28 @@ bool DependencyGraph::is_edge_critical(typename Graph::edge_descriptor e) const
     return false;
 }
 
+void DependencyGraph::index_happens_map(
+    const ordered_map<const IR::MAU::Table *, ordered_set<const IR::MAU::Table *>> &map,
+    const assoc::hash_map<const IR::MAU::Table *, unsigned> &index, std::vector<bitvec> &bits) {
+    bits.assign(index.size(), bitvec());
+    for (auto &[table, related] : map) {
+        auto row = index.find(table);
+        if (row == index.end()) continue;
+        for (auto *other : related) {
+            auto col = index.find(other);
+            if (col != index.end()) bits[row->second].setbit(col->second);
+        }
+    }
+}
+
+void DependencyGraph::index_happens_maps() {
+    index_happens_map(happens_phys_before_map, table_index, happens_phys_before_bits);
+    index_happens_map(happens_phys_after_map, table_index, happens_phys_after_bits);
+    index_happens_map(happens_before_control_map, table_index, happens_before_control_bits);
+    index_happens_map(happens_logi_before_map, table_index, happens_logi_before_bits);
+    index_happens_map(happens_logi_after_map, table_index, happens_logi_after_bits);
+}
+
 std::optional<ordered_map<
     std::pair<const PHV::Field *, DependencyGraph::dependencies_t>,
     std::pair<ordered_set<const IR::MAU::Action *>, ordered_set<const IR::MAU::Action *>>>>
@@ -2372,6 +2394,7 @@ void FindDependencyGraph::finalize_dependence_graph(void) {
     verify_dependence_graph();
     if (LOGGING(4)) DependencyGraph::dump_viz(std::cout, dg);
     calc_max_min_stage();
+    dg.index_happens_maps();
     dg.finalized = true;
 }
 
@@ -22,6 +22,7 @@
 #include <map>
 #include <optional>
 #include <set>
+#include <vector>
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/transitive_closure.hpp>
@@ -35,6 +36,7 @@
 #include "backends/tofino/bf-p4c/mau/table_flow_graph.h"
 #include "backends/tofino/bf-p4c/mau/table_mutex.h"
 #include "backends/tofino/bf-p4c/phv/phv_fields.h"
+#include "lib/bitvec.h"
 
 using namespace P4;
 
@@ -161,6 +163,37 @@ struct DependencyGraph {
         if (!finalized) BUG("Dependency graph used before being fully constructed.");
     }
 
+    // Vertex index of each table; vertices are numbered densely from 0.
+    assoc::hash_map<const IR::MAU::Table *, unsigned> table_index;
+
+    // Bit-matrix form of the happens_*_map relations below: bit j of row i is set if the table
+    // with vertex index j is in the set of the table with vertex index i.  Built from the maps by
+    // index_happens_maps() when the graph is finalized, so that the happens_* queries are bit
+    // tests instead of lookups in ordered maps and sets.  The maps are kept for iteration, as
+    // their insertion order matters to table placement.
+    std::vector<bitvec> happens_phys_before_bits, happens_phys_after_bits,
+        happens_before_control_bits, happens_logi_before_bits, happens_logi_after_bits;
+
+    static void index_happens_map(
+        const ordered_map<const IR::MAU::Table *, ordered_set<const IR::MAU::Table *>> &map,
+        const assoc::hash_map<const IR::MAU::Table *, unsigned> &index,
+        std::vector<bitvec> &bits);
+
+    /// @returns the row of @p bits for @p t, or nullptr if @p t has none.
+    const bitvec *happens_row(const std::vector<bitvec> &bits, const IR::MAU::Table *t) const {
+        auto it = table_index.find(t);
+        if (it == table_index.end() || it->second >= bits.size()) return nullptr;
+        return &bits[it->second];
+    }
+
+    bool test_happens_bit(const std::vector<bitvec> &bits, const IR::MAU::Table *t1,
+                          const IR::MAU::Table *t2) const {
+        auto *row = happens_row(bits, t1);
+        if (!row) return false;
+        auto it = table_index.find(t2);
+        return it != table_index.end() && (*row)[it->second];
+    }
+
     void check_stage_info_exist(const IR::MAU::Table *t) const {
         if (!stage_info.count(t)) {
             BUG("table not exists in Dependency graph: %1%", cstring::to_cstring(t));
@@ -308,6 +341,12 @@ struct DependencyGraph {
         happens_before_control_map.clear();
         happens_logi_after_map.clear();
         happens_logi_before_map.clear();
+        happens_phys_before_bits.clear();
+        happens_phys_after_bits.clear();
+        happens_before_control_bits.clear();
+        happens_logi_before_bits.clear();
+        happens_logi_after_bits.clear();
+        table_index.clear();
         dep_type_map.clear();
         labelToVertex.clear();
         dependency_map.clear();
@@ -386,6 +425,7 @@ struct DependencyGraph {
         } else {
             auto v = boost::add_vertex(label, g);
             labelToVertex[label] = v;
+            table_index[label] = v;
             stage_info[label] = {0, 0, 0, 0, 0, 0, 0};
             return v;
         }
@@ -413,29 +453,25 @@ struct DependencyGraph {
         return true;
     }
 
+    /// Rebuilds the bit-matrix form of the happens_*_map relations.  Must be called again if
+    /// the maps are changed after the graph has been finalized.
+    void index_happens_maps();
+
     bool happens_phys_before(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_phys_before_map.count(t1)) {
-            return happens_phys_before_map.at(t1).count(t2);
-        } else {
-            return false;
-        }
+        return test_happens_bit(happens_phys_before_bits, t1, t2);
     }
 
     bool happens_phys_after(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_phys_after_map.count(t1)) {
-            return happens_phys_after_map.at(t1).count(t2);
-        } else {
-            return false;
-        }
+        return test_happens_bit(happens_phys_after_bits, t1, t2);
     }
 
     // returns true if any table in s or control dependent on a table in s is
     // data dependent on t1
     bool happens_phys_before_recursive(const IR::MAU::Table *t1, const IR::MAU::TableSeq *s) const {
         check_finalized();
-        if (happens_phys_before_map.count(t1))
+        if (happens_row(happens_phys_before_bits, t1))
             for (auto *t2 : s->tables)
                 if (happens_phys_before_recursive(t1, t2)) return true;
         return false;
@@ -444,8 +480,8 @@ struct DependencyGraph {
     // returns true if t2 or any table control dependent on it is data dependent on t1
     bool happens_phys_before_recursive(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_phys_before_map.count(t1)) {
-            if (t2 != t1 && happens_phys_before_map.at(t1).count(t2)) return true;
+        if (happens_row(happens_phys_before_bits, t1)) {
+            if (t2 != t1 && test_happens_bit(happens_phys_before_bits, t1, t2)) return true;
             for (auto *next : Values(t2->next))
                 if (happens_phys_before_recursive(t1, next)) return true;
         }
@@ -454,26 +490,17 @@ struct DependencyGraph {
 
     bool happens_before_control(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_before_control_map.count(t1))
-            return happens_before_control_map.at(t1).count(t2);
-        else
-            return false;
+        return test_happens_bit(happens_before_control_bits, t1, t2);
     }
 
     bool happens_logi_before(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_logi_before_map.count(t1))
-            return happens_logi_before_map.at(t1).count(t2);
-        else
-            return false;
+        return test_happens_bit(happens_logi_before_bits, t1, t2);
     }
 
     bool happens_logi_after(const IR::MAU::Table *t1, const IR::MAU::Table *t2) const {
         check_finalized();
-        if (happens_logi_after_map.count(t1))
-            return happens_logi_after_map.at(t1).count(t2);
-        else
-            return false;
+        return test_happens_bit(happens_logi_after_bits, t1, t2);
     }
 
     std::optional<ordered_map<const PHV::Field *, std::pair<ordered_set<const IR::MAU::Action *>,
@@ -82,12 +82,16 @@
 #include <unistd.h>
 
 #include <sys/stat.h>
+#include <sys/wait.h>
 
+#include <cerrno>
 #include <climits>
 #include <csignal>
 #include <cstdio>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "backends/graphs/controls.h"
 #include "backends/graphs/graph_visitor.h"
@@ -414,6 +418,185 @@ int handle_return(const int error_code, [[maybe_unused]] const BFN_Options &opti
     return error_code;
 }
 
+#if BFP4C_CATCH_EXCEPTIONS
+/// Reports the exception being handled and returns the exit code. Pipe worker processes
+/// (--parallel-pipes) pass @p stats = false and leave the statistics to the parent.
+static int handle_exception(const BFN_Options &options, bool stats = true) {
+    try {
+        throw;
+    } catch (const Util::CompilerBug &e) {
+        BFNContext::get().errorReporter().increment_the_error_count();
+        if (stats) report_stats();
+
+#ifdef BAREFOOT_INTERNAL
+        bool barefootInternal = true;
+#else
+        bool barefootInternal = false;
+#endif
+
+        if (std::string(e.what()).find(".p4(") != std::string::npos || barefootInternal)
+            std::cerr << e.what() << std::endl;
+        std::cerr << "Internal compiler error. Please submit a bug report with your code."
+                  << std::endl;
+        return INTERNAL_COMPILER_ERROR;
+    } catch (const Util::CompilerUnimplemented &e) {
+        BFNContext::get().errorReporter().increment_the_error_count();
+        if (stats) report_stats();
+
+        std::cerr << e.what() << std::endl;
+        return COMPILER_ERROR;
+    } catch (const Util::CompilationError &e) {
+        std::cerr << e.what() << std::endl;
+        return stats ? handle_return(PROGRAM_ERROR, options) : PROGRAM_ERROR;
+#if BAREFOOT_INTERNAL
+    } catch (const std::exception &e) {
+        BFNContext::get().errorReporter().increment_the_error_count();
+        if (stats) report_stats();
+
+        std::cerr << "Internal compiler error: " << e.what() << std::endl;
+        return INTERNAL_COMPILER_ERROR;
+#endif
+    } catch (...) {
+        BFNContext::get().errorReporter().increment_the_error_count();
+        if (stats) report_stats();
+
+        std::cerr << "Internal compiler error. Please submit a bug report with your code."
+                  << std::endl;
+        return INTERNAL_COMPILER_ERROR;
+    }
+}
+#endif  // BFP4C_CATCH_EXCEPTIONS
+
+/// Body of a --parallel-pipes worker process: compiles @p maupipe and writes its exit code,
+/// the errors and warnings it added to @p baseErrors and @p baseWarnings, and the outputs it
+/// added to the manifest to @p fd. Diagnostics go directly to the inherited stderr.
+[[noreturn]] static void run_pipe_worker(const IR::BFN::Pipe *maupipe, BFN_Options &options,
+                                         int fd, unsigned baseErrors, unsigned baseWarnings) {
+    int code = SUCCESS;
+#if BFP4C_CATCH_EXCEPTIONS
+    try {
+#endif  // BFP4C_CATCH_EXCEPTIONS
+        LOG3("Executing backend for pipe : " << maupipe->canon_name());
+        EventLogger::get().pipeChange(maupipe->canon_id());
+        execute_backend(maupipe, options);
+        if (::errorCount() > baseErrors) code = COMPILER_ERROR;
+#if BFP4C_CATCH_EXCEPTIONS
+    } catch (...) {
+        code = handle_exception(options, false);
+    }
+#endif  // BFP4C_CATCH_EXCEPTIONS
+
+    auto &reporter = BFNContext::get().errorReporter();
+    std::ostringstream report;
+    report << code << " " << reporter.getErrorCount() - baseErrors << " "
+           << reporter.getWarningCount() - baseWarnings << "\n";
+    for (int pipe_id : maupipe->ids)
+        Logging::Manifest::getManifest().writePipeOutputs(report, pipe_id);
+    auto data = report.str();
+    for (size_t written = 0; written < data.size();) {
+        auto n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) break;
+        written += n;
+    }
+    close(fd);
+    std::cout << std::flush;
+    std::cerr << std::flush;
+    std::clog << std::flush;
+    fflush(nullptr);
+    // Skip the exit handlers and static destructors: they belong to the parent, and would
+    // write the manifest a second time.
+    _exit(0);
+}
+
+/// Compiles each of @p pipes in a worker process of its own, so that a multi-pipe program
+/// takes about as long as its slowest pipe. The workers inherit the midend IR through fork;
+/// each reports its error counts and manifest entries back through a pipe, and writes all
+/// other outputs to its pipe-specific output directories. Unlike the sequential loop, an
+/// error in one pipe does not stop the compilation of the others.
+/// @returns the exit code of the first failed worker, or SUCCESS.
+static int execute_backends_in_parallel(const std::vector<const IR::BFN::Pipe *> &pipes,
+                                        BFN_Options &options) {
+    struct Worker {
+        const IR::BFN::Pipe *maupipe;
+        pid_t pid;
+        int fd;
+    };
+    auto &reporter = BFNContext::get().errorReporter();
+    unsigned baseErrors = reporter.getErrorCount();
+    unsigned baseWarnings = reporter.getWarningCount();
+    int result = SUCCESS;
+
+    // Anything still buffered would be written by every worker.
+    std::cout << std::flush;
+    std::cerr << std::flush;
+    std::clog << std::flush;
+    fflush(nullptr);
+
+    std::vector<Worker> workers;
+    for (auto *maupipe : pipes) {
+        int fds[2];
+        pid_t child = -1;
+        if (pipe(fds) == 0) {
+            child = fork();
+            // The process limit may clear as other processes exit: retry a few times, with a
+            // growing delay, before compiling this pipe here instead.
+            for (unsigned delayMs = 10; child == -1 && errno == EAGAIN && delayMs <= 160;
+                 delayMs *= 2) {
+                usleep(delayMs * 1000);
+                child = fork();
+            }
+            if (child == -1) {
+                close(fds[0]);
+                close(fds[1]);
+            }
+        }
+        if (child == -1) {
+            // Out of processes: compile this pipe here instead.
+            LOG3("Executing backend for pipe : " << maupipe->canon_name());
+            EventLogger::get().pipeChange(maupipe->canon_id());
+            execute_backend(maupipe, options);
+            continue;
+        }
+        if (child == 0) {
+            close(fds[0]);
+            for (auto &worker : workers) close(worker.fd);
+            run_pipe_worker(maupipe, options, fds[1], baseErrors, baseWarnings);
+        }
+        close(fds[1]);
+        workers.push_back({maupipe, child, fds[0]});
+    }
+
+    cstring crashed;
+    for (auto &worker : workers) {
+        std::string report;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = read(worker.fd, buffer, sizeof(buffer))) != 0) {
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) break;
+            report.append(buffer, n);
+        }
+        close(worker.fd);
+        int status = 0;
+        while (waitpid(worker.pid, &status, 0) == -1 && errno == EINTR) {
+        }
+
+        std::istringstream in(report);
+        int code;
+        unsigned errors, warnings;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || !(in >> code >> errors >> warnings)) {
+            if (!crashed) crashed = worker.maupipe->canon_name();
+            continue;
+        }
+        reporter.add_worker_counts(errors, warnings);
+        Logging::Manifest::getManifest().readPipeOutputs(in);
+        if (result == SUCCESS) result = code;
+    }
+    BUG_CHECK(!crashed, "Worker process compiling %1% terminated abnormally", crashed);
+    return result;
+}
+
 int main(int ac, char **av) {
     setup_gc_logging();
     setup_signals();
@@ -567,6 +750,10 @@ int main(int ac, char **av) {
         };
         manifest_generator_guard emit_manifest(manifest);
 
+        // The event log is a single file shared by all pipes, so it needs sequential compilation.
+        bool parallel = options.parallel_pipes && !options.enable_event_logger &&
+                        substitute.pipe.size() > 1;
+        std::vector<const IR::BFN::Pipe *> deferred_pipes;
         for (auto &pipe : substitute.pipe) {
 #if BAREFOOT_INTERNAL
             if (std::all_of(pipe->names.begin(), pipe->names.end(),
@@ -611,10 +798,20 @@ int main(int ac, char **av) {
                 }
             }
 
+            if (parallel) {
+                deferred_pipes.push_back(pipe);
+                continue;
+            }
             LOG3("Executing backend for pipe : " << pipe->canon_name());
             EventLogger::get().pipeChange(pipe->canon_id());
             execute_backend(pipe, options);
         }
+        if (!deferred_pipes.empty() && ::errorCount() == 0) {
+            auto status = execute_backends_in_parallel(deferred_pipes, options);
+            if (status != SUCCESS && status != COMPILER_ERROR) {
+                return handle_return(status, options);
+            }
+        }
 
         report_stats();
 
@@ -632,45 +829,8 @@ int main(int ac, char **av) {
 
 #if BFP4C_CATCH_EXCEPTIONS
         // catch all exceptions here
-    } catch (const Util::CompilerBug &e) {
-        BFNContext::get().errorReporter().increment_the_error_count();
-        report_stats();
-
-#ifdef BAREFOOT_INTERNAL
-        bool barefootInternal = true;
-#else
-        bool barefootInternal = false;
-#endif
-
-        if (std::string(e.what()).find(".p4(") != std::string::npos || barefootInternal)
-            std::cerr << e.what() << std::endl;
-        std::cerr << "Internal compiler error. Please submit a bug report with your code."
-                  << std::endl;
-        return INTERNAL_COMPILER_ERROR;
-    } catch (const Util::CompilerUnimplemented &e) {
-        BFNContext::get().errorReporter().increment_the_error_count();
-        report_stats();
-
-        std::cerr << e.what() << std::endl;
-        return COMPILER_ERROR;
-    } catch (const Util::CompilationError &e) {
-        std::cerr << e.what() << std::endl;
-        return handle_return(PROGRAM_ERROR, options);
-#if BAREFOOT_INTERNAL
-    } catch (const std::exception &e) {
-        BFNContext::get().errorReporter().increment_the_error_count();
-        report_stats();
-
-        std::cerr << "Internal compiler error: " << e.what() << std::endl;
-        return INTERNAL_COMPILER_ERROR;
-#endif
     } catch (...) {
-        BFNContext::get().errorReporter().increment_the_error_count();
-        report_stats();
-
-        std::cerr << "Internal compiler error. Please submit a bug report with your code."
-                  << std::endl;
-        return INTERNAL_COMPILER_ERROR;
+        return handle_exception(options);
     }
 #endif  // BFP4C_CATCH_EXCEPTIONS
 }
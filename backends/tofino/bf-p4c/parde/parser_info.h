@@ -21,6 +21,9 @@
 
 #include <numeric>
 #include <optional>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/copy.hpp>
@@ -261,6 +264,12 @@ class ParserGraphImpl : public DirectedGraph {
 
         if (predecessors().at(dst).count(src)) return true;
 
+#ifdef MULTITHREAD
+        // PHV allocation queries the graph from several workers.
+        static std::recursive_mutex is_ancestor_mutex;
+        std::lock_guard<std::recursive_mutex> guard(is_ancestor_mutex);
+#endif
+
         if (is_ancestor_.count(src) && is_ancestor_.at(src).count(dst))
             return is_ancestor_.at(src).at(dst);
 
@@ -49,6 +49,7 @@
 #include "backends/tofino/bf-p4c/phv/utils/slice_alloc.h"
 #include "backends/tofino/bf-p4c/phv/utils/utils.h"
 #include "ir/ir.h"
+#include "ir/pass_utils.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
 #include "lib/log.h"
@@ -4587,7 +4588,8 @@ BruteForceAllocationStrategy::BruteForceAllocationStrategy(const cstring name,
       empty_alloc_i(empty_alloc),
       config_i(config),
       pipe_id_i(pipeId),
-      phv_i(phv) {}
+      phv_i(phv),
+      jobs_i(BackendOptions().phv_alloc_workers) {}
 
 ordered_set<bitvec> BruteForceAllocationStrategy::calc_slicing_schemas(
     const PHV::SuperCluster *sc, const std::set<PHV::ConcreteAllocation::AvailableSpot> &spots) {
@@ -5331,6 +5333,9 @@ bool BruteForceAllocationStrategy::tryAllocSlicing(
     const ScoreContext &score_ctx) {
     LOG_DEBUG4("Try alloc slicing:");
 
+    const std::vector<PHV::ContainerGroup *> groups(container_groups.begin(),
+                                                    container_groups.end());
+
     // Place all slices, then get score for that placement.
     for (auto *sc : slicing) {
         // Find best container group for this slice.
@@ -5339,15 +5344,43 @@ bool BruteForceAllocationStrategy::tryAllocSlicing(
         LOG_DEBUG4("Searching for container group to allocate supercluster with Uid " << sc->uid
                                                                                       << " into");
 
-        for (PHV::ContainerGroup *container_group : container_groups) {
+        // Each candidate is a separate transaction on top of slicing_alloc.
+        std::vector<std::optional<PHV::Transaction>> partial_allocs(groups.size());
+        std::vector<AllocScore> scores(groups.size());
+        auto evaluate = [&](size_t i) {
+            partial_allocs[i] = core_alloc_i.try_alloc(slicing_alloc, *groups[i], *sc,
+                                                       config_i.max_sl_alignment, score_ctx);
+            if (partial_allocs[i])
+                scores[i] =
+                    score_ctx.make_score(*partial_allocs[i], utils_i.phv, utils_i.clot,
+                                         utils_i.uses, utils_i.field_to_parser_states,
+                                         utils_i.parser_critical_path, utils_i.tablePackOpt);
+        };
+        bool evaluated = false;
+#ifdef MULTITHREAD
+        // Unless the first group that fits is taken, every candidate is evaluated anyway, so
+        // they can be evaluated concurrently.  The results are still compared in container group
+        // order below, which makes the choice the same as that of a serial run.  Logging stays
+        // serial: the workers would interleave their output and share the indentation state of
+        // the log streams.
+        if (!score_ctx.stop_at_first() && groups.size() > 1 && jobs_i != 1 &&
+            !Log::anyFileLogLevelIsAtLeast(1)) {
+            // Fill the lazily computed state of slicing_alloc before the workers share it.
+            slicing_alloc.getParserStateToContainers(utils_i.phv, utils_i.field_to_parser_states);
+            slicing_alloc.setConcurrentReads(true);
+            forEachIndex(groups.size(), jobs_i, evaluate);
+            slicing_alloc.setConcurrentReads(false);
+            evaluated = true;
+        }
+#endif
+
+        for (size_t i = 0; i < groups.size(); ++i) {
+            PHV::ContainerGroup *container_group = groups[i];
             LOG_FEATURE("alloc_progress", 5, "\nTrying container group: " << container_group);
 
-            if (auto partial_alloc = core_alloc_i.try_alloc(slicing_alloc, *container_group, *sc,
-                                                            config_i.max_sl_alignment, score_ctx)) {
-                AllocScore score =
-                    score_ctx.make_score(*partial_alloc, utils_i.phv, utils_i.clot, utils_i.uses,
-                                         utils_i.field_to_parser_states,
-                                         utils_i.parser_critical_path, utils_i.tablePackOpt);
+            if (!evaluated) evaluate(i);
+            if (auto &partial_alloc = partial_allocs[i]) {
+                const AllocScore &score = scores[i];
                 LOG_DEBUG4("Allocation score: " << score);
                 if (!best_slice_alloc || score_ctx.is_better(score, best_slice_score)) {
                     best_slice_score = score;
@@ -699,6 +699,9 @@ class BruteForceAllocationStrategy : public AllocationStrategy {
     std::optional<const PHV::SuperCluster::SliceList *> unallocatable_list_i;
     int pipe_id_i;   /// used for logging purposes
     PhvInfo &phv_i;  // mutable because of deparsed zero allocation.
+    /// Worker threads evaluating container groups in MULTITHREAD builds, 0 for one per hardware
+    /// thread (--phv-alloc-workers).
+    unsigned jobs_i;
 
  public:
     BruteForceAllocationStrategy(const cstring name, const PHV::AllocUtils &utils,
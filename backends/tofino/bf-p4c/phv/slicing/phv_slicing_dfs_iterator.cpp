@@ -19,6 +19,7 @@
 #include "backends/tofino/bf-p4c/phv/slicing/phv_slicing_dfs_iterator.h"
 
 #include <algorithm>
+#include <chrono>
 #include <climits>
 #include <iterator>
 #include <numeric>
@@ -27,7 +28,9 @@
 
 #include <boost/range/adaptor/reversed.hpp>
 
+#include "backends/tofino/bf-p4c/bf-p4c-options.h"
 #include "backends/tofino/bf-p4c/ir/bitrange.h"
+#include "backends/tofino/bf-p4c/logging/event_logger.h"
 #include "backends/tofino/bf-p4c/logging/logging.h"
 #include "backends/tofino/bf-p4c/phv/error.h"
 #include "backends/tofino/bf-p4c/phv/phv_fields.h"
@@ -50,6 +53,19 @@ struct DeferHelper {
     virtual ~DeferHelper() { defer(); }
 };
 
+/// Steps and microseconds taken by the searches of all super clusters, checked against the
+/// total search budget. They are counted per process, so the budget covers the whole
+/// compilation, or a single pipe with --parallel-pipes, which compiles each pipe in a process
+/// of its own.
+int64_t total_search_steps = 0;
+int64_t total_search_us = 0;
+
+int64_t elapsed_us(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - since)
+        .count();
+}
+
 bool overlapped(const PHV::SuperCluster::SliceList *a, const PHV::SuperCluster::SliceList *b) {
     for (const auto &fs_a : *a) {
         for (const auto &fs_b : *b) {
@@ -1187,6 +1203,12 @@ std::optional<std::list<SuperCluster *>> DfsItrContext::split_by_pa_container_si
 void DfsItrContext::iterate(const IterateCb &cb) {
     BUG_CHECK(!has_itr_i, "One ItrContext can only generate one iterator.");
     has_itr_i = true;
+    apply_budget_options();
+    search_start_i = std::chrono::steady_clock::now();
+    DeferHelper charge_total_budget([this]() {
+        total_search_steps += n_steps_i;
+        total_search_us += elapsed_us(search_start_i);
+    });
 
     LOG3("Making Itr for " << sc_i);
     LOG7("Homogeneous slicing enabled: " << config_i.homogeneous_slicing
@@ -1284,10 +1306,12 @@ void DfsItrContext::iterate(const IterateCb &cb) {
     // to_be_split_i = *after_pre_split;
 
     // start searching.
+    record_partial_solution();
     auto res = dfs(cb, to_be_split_i);
     LOG1("DFS Result: " << res << ", n_steps_since_last_solution: " << n_steps_since_last_solution
                         << ", max_search_steps_per_solution: "
-                        << config_i.max_search_steps_per_solution);
+                        << config_i.max_search_steps_per_solution
+                        << ", budget_exhausted: " << budget_exhausted_i);
 
     // true indicates that we had troubles in finding a solution. Try aggressively presplit
     // large fieldslice to 32-bit chunks first and then rerun dfs.
@@ -1297,7 +1321,8 @@ void DfsItrContext::iterate(const IterateCb &cb) {
     // An example is that when there are multiple bit<128> fields being searched for different
     // slicing between two critical choices, and the slicing of bit<128> fields does not matter.
     // TODO: There should be a algorithmic way to prune those cases.
-    if (n_steps_since_last_solution > config_i.max_search_steps_per_solution) {
+    if (!budget_exhausted_i &&
+        n_steps_since_last_solution > config_i.max_search_steps_per_solution) {
         LOG1(
             "failed to find one valid solution within step limit. "
             "Retry with pre-splitting large fieldslice");
@@ -1312,20 +1337,95 @@ void DfsItrContext::iterate(const IterateCb &cb) {
             "split_by_long_fieldslices"_cs);
         if (!after_pre_split) {
             LOG1("split by split_by_long_fieldslices fields failed, iteration stopped.");
-            return;
-        }
-        if (!is_any_long_field_split) {
+        } else if (!is_any_long_field_split) {
             LOG1(
                 "no optimization applied while we cannot find a solution in limited steps, "
                 "iteration stopped.");
-            return;
+        } else {
+            to_be_split_i = *after_pre_split;
+
+            // restart searching.
+            n_steps_since_last_solution = 0;
+            dfs(cb, to_be_split_i);
         }
-        to_be_split_i = *after_pre_split;
+    }
 
-        // restart searching.
-        n_steps_since_last_solution = 0;
-        dfs(cb, to_be_split_i);
+    yield_partial_solution(cb);
+}
+
+void DfsItrContext::apply_budget_options() {
+    const auto &options = BackendOptions();
+    if (options.phv_slicing_cluster_max_steps > 0)
+        config_i.max_search_steps = options.phv_slicing_cluster_max_steps;
+    if (options.phv_slicing_cluster_max_seconds > 0)
+        config_i.max_search_seconds = options.phv_slicing_cluster_max_seconds;
+    if (options.phv_slicing_max_steps > 0)
+        config_i.max_total_search_steps = options.phv_slicing_max_steps;
+    if (options.phv_slicing_max_seconds > 0)
+        config_i.max_total_search_seconds = options.phv_slicing_max_seconds;
+}
+
+bool DfsItrContext::over_budget() const {
+    if (n_steps_i > config_i.max_search_steps) return true;
+    if (config_i.max_total_search_steps > 0 &&
+        total_search_steps + n_steps_i > config_i.max_total_search_steps) {
+        return true;
+    }
+    // reading the clock on every step would slow the search down, so time is only checked
+    // on the first step and every 1024 steps after it.
+    if (n_steps_i % 1024 != 1) return false;
+    const int64_t us = elapsed_us(search_start_i);
+    if (config_i.max_search_seconds > 0 && us > config_i.max_search_seconds * 1000000LL) {
+        return true;
+    }
+    return config_i.max_total_search_seconds > 0 &&
+           total_search_us + us > config_i.max_total_search_seconds * 1000000LL;
+}
+
+void DfsItrContext::record_partial_solution() {
+    if (best_partial_solution_i && done_i.size() <= best_partial_solution_n_done_i) return;
+    for (auto *sc : to_be_split_i) {
+        if (!SuperCluster::is_well_formed(sc)) return;
     }
+    best_partial_solution_i = std::list<SuperCluster *>(done_i.begin(), done_i.end());
+    best_partial_solution_i->insert(best_partial_solution_i->end(), to_be_split_i.begin(),
+                                    to_be_split_i.end());
+    best_partial_solution_n_done_i = done_i.size();
+}
+
+void DfsItrContext::log_progress() const {
+    std::stringstream ss;
+    ss << "PHV slicing of super cluster " << sc_i->uid << ": " << n_steps_i << " steps in "
+       << elapsed_us(search_start_i) / 1000 << " ms, " << n_solutions_i << " solutions, "
+       << n_steps_since_last_solution << " steps since the last one, dfs depth " << dfs_depth_i
+       << ", " << done_i.size() << " super clusters done, " << to_be_split_i.size()
+       << " to be split";
+    // the bottom of the stack is the decision that the search has not been able to revise.
+    if (!slicelist_on_stack_i.empty()) {
+        ss << ", first split " << slicelist_on_stack_i.front() << ", last split "
+           << slicelist_on_stack_i.back();
+    }
+    EventLogger::get().debug(2, __FILE__, ss.str());
+}
+
+void DfsItrContext::yield_partial_solution(const IterateCb &cb) {
+    if (n_solutions_i > 0 || !budget_exhausted_i) return;
+    std::stringstream why;
+    why << "no slicing found in " << n_steps_i << " steps and "
+        << elapsed_us(search_start_i) / 1000 << " ms, search budget spent";
+    const std::string description =
+        "PHV slicing of super cluster " + std::to_string(sc_i->uid) + " stopped";
+    if (!best_partial_solution_i) {
+        EventLogger::get().debug(1, __FILE__,
+                                 description + " without any well-formed slicing: " + why.str());
+        return;
+    }
+    std::stringstream what;
+    what << "partial slicing of " << best_partial_solution_i->size() << " super clusters, "
+         << best_partial_solution_n_done_i << " of them fully split";
+    EventLogger::get().decision(1, __FILE__, description, what.str(), why.str());
+    n_solutions_i++;
+    cb(*best_partial_solution_i);
 }
 
 bool DfsItrContext::need_further_split(const SuperCluster::SliceList *sl) const {
@@ -2034,11 +2134,15 @@ bool DfsItrContext::check_duplicate_slicing_plan(const ordered_set<SuperCluster
 
 // return false if iteration should be terminated.
 bool DfsItrContext::dfs(const IterateCb &yield, const ordered_set<SuperCluster *> &unchecked) {
-    // prune when we reached the limit of steps.
+    // prune when we reached the limit of steps or time.
     n_steps_i++;
-    if (n_steps_i > config_i.max_search_steps) {
+    if (over_budget()) {
+        budget_exhausted_i = true;
         return false;
     }
+    if (config_i.progress_event_steps > 0 && n_steps_i % config_i.progress_event_steps == 0) {
+        log_progress();
+    }
 
     // prune when we spend too much time in finding one solution.
     // It usually means that we made wrong decisions at the beginning of DFS, that
@@ -2082,8 +2186,10 @@ bool DfsItrContext::dfs(const IterateCb &yield, const ordered_set<SuperCluster *
         }
         LOG4("found a solution after " << n_steps_i << " steps");
         n_steps_since_last_solution = 0;
+        n_solutions_i++;
         return yield(std::list<SuperCluster *>(done_i.begin(), done_i.end()));
     }
+    if (n_solutions_i == 0) record_partial_solution();
 
     // search
     auto target = dfs_pick_next();
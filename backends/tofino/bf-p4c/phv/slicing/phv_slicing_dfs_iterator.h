@@ -19,6 +19,9 @@
 #ifndef BACKENDS_TOFINO_BF_P4C_PHV_SLICING_PHV_SLICING_DFS_ITERATOR_H_
 #define BACKENDS_TOFINO_BF_P4C_PHV_SLICING_PHV_SLICING_DFS_ITERATOR_H_
 
+#include <chrono>
+#include <list>
+#include <optional>
 #include <utility>
 
 #include "backends/tofino/bf-p4c/lib/assoc.h"
@@ -139,6 +142,22 @@ class DfsItrContext : public IteratorInterface {
     // last solution was found at n_steps_since_last_solution before.
     int n_steps_since_last_solution = 0;
 
+    // the number of solutions passed to the callback.
+    int n_solutions_i = 0;
+
+    // when the search started, for the time budget.
+    std::chrono::steady_clock::time_point search_start_i;
+
+    // true if the search stopped because its step or time budget, or the one of all searches,
+    // was spent.
+    bool budget_exhausted_i = false;
+
+    // before the first solution is found, the most refined state of the search, i.e., with the
+    // most super clusters in done_i, in which all super clusters are well-formed. It is passed
+    // to the callback if the search spends its budget without finding any solution.
+    std::optional<std::list<SuperCluster *>> best_partial_solution_i;
+    size_t best_partial_solution_n_done_i = 0;
+
     // Set of rejected SplitChoice options from previous slice-lists
     std::set<SplitChoice> reject_sizes;
 
@@ -195,6 +214,24 @@ class DfsItrContext : public IteratorInterface {
     /// for pruning.
     bool dfs(const IterateCb &yield, const ordered_set<SuperCluster *> &unchecked);
 
+    /// override the search budget in config_i with the one set on the command line.
+    void apply_budget_options();
+
+    /// return true if the search has spent its step or time budget, or the one of all searches.
+    bool over_budget() const;
+
+    /// record the current state of the search as best_partial_solution_i, if it is well-formed
+    /// and more refined than the recorded one.
+    void record_partial_solution();
+
+    /// write the progress of the search to the event log.
+    void log_progress() const;
+
+    /// pass best_partial_solution_i to @p cb, if the search spent its budget without finding
+    /// any solution. Other limits, e.g. max_search_steps_per_solution, end the search without
+    /// a slicing.
+    void yield_partial_solution(const IterateCb &cb);
+
     /// split_by_pa_container_size will split @p sc by @p pa container size.
     std::optional<std::list<SuperCluster *>> split_by_pa_container_size(
         const SuperCluster *sc, const PHVContainerSizeLayout &pa);
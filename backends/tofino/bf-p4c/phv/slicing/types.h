@@ -88,6 +88,18 @@ struct IteratorConfig {
     /// For p4 program with more complicated actions, the duration will be longer.
     int max_search_steps_per_solution = (1 << 16);
 
+    /// the maximum wall-clock time, in seconds, that the search can take. 0 means no limit.
+    int max_search_seconds = 0;
+
+    /// the total number of steps, and seconds, that the searches of all super clusters
+    /// can take together. Once spent, a search stops at its next step. 0 means no limit.
+    int max_total_search_steps = 0;
+    int max_total_search_seconds = 0;
+
+    /// the search writes a progress event to the event log every this many steps, so that
+    /// a search that takes long can be followed. 0 disables the events.
+    int progress_event_steps = (1 << 14);
+
     /// Disable packing checks during slicing. This should only be used for diagnose, so
     /// it is default to false and not shown in any constructor.
     bool disable_packing_check = false;
@@ -41,6 +41,8 @@ int PHV::ClusterStats::nextId = 0;
 
 PHV::Allocation::ContainerStatus PHV::ConcreteAllocation::emptyContainerStatus;
 
+std::atomic<uint64_t> PHV::Allocation::status_generation_i = 1;
+
 PHV::ContainerGroup::ContainerGroup(PHV::Size sz, const std::vector<PHV::Container> containers)
     : size_i(sz), containers_i(containers) {
     // Check that all containers are the right size.
@@ -68,12 +70,29 @@ PHV::ContainerGroup::ContainerGroup(PHV::Size sz, bitvec container_group)
     }
 }
 
+void PHV::Allocation::setStatus(PHV::Container c, const ContainerStatus &status) {
+    auto it = container_status_i.find(c);
+    if (it != container_status_i.end()) {
+        it->second = status;
+        return;
+    }
+    container_status_i.emplace(c, status);
+    // The new status shadows whatever descendant transactions cached from our ancestors.
+    ++status_generation_i;
+}
+
+PHV::Allocation::ContainerStatus &PHV::Allocation::updateStatus(PHV::Container c) {
+    auto it = container_status_i.find(c);
+    BUG_CHECK(it != container_status_i.end(), "No status to update for container %1%", c);
+    return it->second;
+}
+
 bool PHV::Allocation::addStatus(PHV::Container c, const ContainerStatus &status) {
     bool new_slice = !(container_status_i.count(c) &&
-                       container_status_i[c].slices.size() == status.slices.size());
+                       container_status_i.at(c).slices.size() == status.slices.size());
 
     // Update container status.
-    container_status_i[c] = status;
+    setStatus(c, status);
 
     // Update field status.
     for (auto &slice : status.slices) {
@@ -154,34 +173,33 @@ void PHV::Allocation::addSlice(PHV::Container c, PHV::AllocSlice slice) {
     const auto *container_status = this->getStatus(c);
     ContainerStatus status = container_status ? *container_status : ContainerStatus();
     status.slices.insert(slice);
-    container_status_i[c] = status;
+    setStatus(c, status);
 
     // Update field status.
     field_status_i[slice.field()].insert(slice);
 
     // Update the allocation status of the container.
-    if (container_status_i[c].alloc_status != PHV::Allocation::ContainerAllocStatus::FULL) {
-        PHV::Allocation::ContainerAllocStatus old_status = container_status_i[c].alloc_status;
+    auto &new_status = updateStatus(c);
+    if (new_status.alloc_status != PHV::Allocation::ContainerAllocStatus::FULL) {
+        PHV::Allocation::ContainerAllocStatus old_status = new_status.alloc_status;
         bitvec allocated_bits;
-        for (const auto &slice : container_status_i[c].slices)
+        for (const auto &slice : new_status.slices)
             allocated_bits |= bitvec(slice.container_slice().lo, slice.width());
         if (allocated_bits == bitvec())
-            container_status_i[c].alloc_status = PHV::Allocation::ContainerAllocStatus::EMPTY;
+            new_status.alloc_status = PHV::Allocation::ContainerAllocStatus::EMPTY;
         else if (allocated_bits == bitvec(0, c.size()))
-            container_status_i[c].alloc_status = PHV::Allocation::ContainerAllocStatus::FULL;
+            new_status.alloc_status = PHV::Allocation::ContainerAllocStatus::FULL;
         else
-            container_status_i[c].alloc_status = PHV::Allocation::ContainerAllocStatus::PARTIAL;
+            new_status.alloc_status = PHV::Allocation::ContainerAllocStatus::PARTIAL;
 
-        BUG_CHECK(
-            container_status_i[c].alloc_status != PHV::Allocation::ContainerAllocStatus::EMPTY ||
-                (container_status_i[c].alloc_status ==
-                     PHV::Allocation::ContainerAllocStatus::EMPTY &&
-                 container_status_i[c].alloc_status == old_status),
-            "Changing allocation status from FULL or PARTIAL to EMPTY");
+        BUG_CHECK(new_status.alloc_status != PHV::Allocation::ContainerAllocStatus::EMPTY ||
+                      (new_status.alloc_status == PHV::Allocation::ContainerAllocStatus::EMPTY &&
+                       new_status.alloc_status == old_status),
+                  "Changing allocation status from FULL or PARTIAL to EMPTY");
 
-        if (old_status != container_status_i[c].alloc_status) {
+        if (old_status != new_status.alloc_status) {
             --count_by_status_i[c.type().size()][old_status];
-            ++count_by_status_i[c.type().size()][container_status_i[c].alloc_status];
+            ++count_by_status_i[c.type().size()][new_status.alloc_status];
         }
     }
 }
@@ -260,7 +278,7 @@ void PHV::Allocation::setGress(PHV::Container c, GressAssignment gress) {
     const auto *container_status = this->getStatus(c);
     ContainerStatus status = container_status ? *container_status : ContainerStatus();
     status.gress = gress;
-    container_status_i[c] = status;
+    setStatus(c, status);
 }
 
 void PHV::Allocation::setParserGroupGress(PHV::Container c, GressAssignment parserGroupGress) {
@@ -268,7 +286,7 @@ void PHV::Allocation::setParserGroupGress(PHV::Container c, GressAssignment pars
     const auto *container_status = this->getStatus(c);
     ContainerStatus status = container_status ? *container_status : ContainerStatus();
     status.parserGroupGress = parserGroupGress;
-    container_status_i[c] = status;
+    setStatus(c, status);
 }
 
 void PHV::Allocation::setDeparserGroupGress(PHV::Container c, GressAssignment deparserGroupGress) {
@@ -276,7 +294,7 @@ void PHV::Allocation::setDeparserGroupGress(PHV::Container c, GressAssignment de
     const auto *container_status = this->getStatus(c);
     ContainerStatus status = container_status ? *container_status : ContainerStatus();
     status.deparserGroupGress = deparserGroupGress;
-    container_status_i[c] = status;
+    setStatus(c, status);
 }
 
 void PHV::Allocation::setParserExtractGroupSource(PHV::Container c, ExtractSource source) {
@@ -284,7 +302,7 @@ void PHV::Allocation::setParserExtractGroupSource(PHV::Container c, ExtractSourc
     const auto *container_status = this->getStatus(c);
     ContainerStatus status = container_status ? *container_status : ContainerStatus();
     status.parserExtractGroupSource = source;
-    container_status_i[c] = status;
+    setStatus(c, status);
 }
 
 PHV::Allocation::MutuallyLiveSlices PHV::Allocation::liverange_overlapped_slices(
@@ -550,7 +568,7 @@ void PHV::Allocation::removeAllocatedSlice(const ordered_set<PHV::AllocSlice> &s
         }
     }
     for (auto &sl : toBeRemoved) status.slices.erase(sl);
-    container_status_i[c] = status;
+    setStatus(c, status);
     LOG1("\t\t\tNew state of container (after removal)");
     for (auto &sl : this->slices(c)) LOG1("\t\t\t" << sl);
     LOG1("\t\t\tTrying to remove field slices slices");
@@ -636,7 +654,7 @@ PHV::Transaction *PHV::Allocation::clone(const Allocation &parent) const {
                               parent_status->deparserGroupGress == kv.second.deparserGroupGress);
         if (!new_slice && !gress_assign) continue;
 
-        rv->container_status_i[kv.first] = kv.second;
+        rv->setStatus(kv.first, kv.second);
     }
 
     for (const auto &kv : meta_init_points_i)
@@ -782,12 +800,12 @@ PHV::ConcreteAllocation::ConcreteAllocation(const PhvInfo &phv, const PhvUse &us
             parserGroupGress = EGRESS;
             deparserGroupGress = EGRESS;
         }
-        container_status_i[c] = {gress,
-                                 parserGroupGress,
-                                 deparserGroupGress,
-                                 {},
-                                 PHV::Allocation::ContainerAllocStatus::EMPTY,
-                                 PHV::Allocation::ExtractSource::NONE};
+        setStatus(c, {gress,
+                      parserGroupGress,
+                      deparserGroupGress,
+                      {},
+                      PHV::Allocation::ContainerAllocStatus::EMPTY,
+                      PHV::Allocation::ExtractSource::NONE});
     }
     // set phv state
     for (const auto &f : phv) {
@@ -856,9 +874,9 @@ void PHV::ConcreteAllocation::deallocate(const ordered_set<PHV::AllocSlice> &sli
     for (const auto &sl : slices) {
         auto c = sl.container();
         touched_conts.insert(c);
-        BUG_CHECK(container_status_i.count(c) && container_status_i[c].slices.count(sl),
+        BUG_CHECK(container_status_i.count(c) && container_status_i.at(c).slices.count(sl),
                   "slice does not seem to be allocated: %1%", sl);
-        container_status_i[c].slices.erase(sl);
+        updateStatus(c).slices.erase(sl);
         field_status_i[sl.field()].erase(sl);
     }
     // TODO: This is still not 100% correct because if we just removed deparsed
@@ -868,27 +886,28 @@ void PHV::ConcreteAllocation::deallocate(const ordered_set<PHV::AllocSlice> &sli
     // update gress and status if container is empty after deallocation.
     const auto &phv_spec = Device::phvSpec();
     for (const auto &c : touched_conts) {
-        if (!container_status_i[c].slices.empty()) continue;
+        auto &status = updateStatus(c);
+        if (!status.slices.empty()) continue;
         const unsigned cid = phv_spec.containerToId(c);
-        container_status_i[c].alloc_status = ContainerAllocStatus::EMPTY;
+        status.alloc_status = ContainerAllocStatus::EMPTY;
         if (!phv_spec.ingressOnly()[cid] && !phv_spec.egressOnly()[cid]) {
-            container_status_i[c].gress = std::nullopt;
+            status.gress = std::nullopt;
             // reset parser group gress.
-            container_status_i[c].parserGroupGress = std::nullopt;
+            status.parserGroupGress = std::nullopt;
             for (const unsigned other_cid : phv_spec.parserGroup(cid)) {
                 if (other_cid == cid) continue;
                 const auto other = phv_spec.idToContainer(other_cid);
                 const auto other_parser_group_gress = this->parserGroupGress(other);
-                container_status_i[c].parserGroupGress = other_parser_group_gress;
+                status.parserGroupGress = other_parser_group_gress;
                 break;
             }
             // reset deparser group gress.
-            container_status_i[c].deparserGroupGress = std::nullopt;
+            status.deparserGroupGress = std::nullopt;
             for (const unsigned other_cid : phv_spec.deparserGroup(cid)) {
                 if (other_cid == cid) continue;
                 const auto other = phv_spec.idToContainer(other_cid);
                 const auto other_deparser_group_gress = this->deparserGroupGress(other);
-                container_status_i[c].deparserGroupGress = other_deparser_group_gress;
+                status.deparserGroupGress = other_deparser_group_gress;
                 break;
             }
         }
@@ -998,15 +1017,31 @@ const PHV::Allocation::ContainerStatus *PHV::Transaction::getStatus(const PHV::C
     // parent.
     auto it = container_status_i.find(c);
     if (it != container_status_i.end()) return &it->second;
+    if (concurrent_reads_i) return parent_i->findStatus(c);
+
+    // Otherwise, use the status cached from the ancestors, unless a status was added to or
+    // removed from any allocation since.  The cache holds pointers rather than copies, so reads
+    // neither copy the slices at every level nor add entries that commit() has to merge back.
+    const unsigned id = Device::phvSpec().containerToId(c);
+    if (id >= parent_status_cache_i.size()) parent_status_cache_i.resize(id + 1);
+    auto &cached = parent_status_cache_i[id];
+    const uint64_t generation = status_generation_i;
+    if (cached.generation != generation) {
+        cached.status = parent_i->findStatus(c);
+        cached.generation = generation;
+    }
+    return cached.status;
+}
 
-    // Otherwise, retrieve and cache parent info.
-    const auto *parentStatus = parent_i->getStatus(c);
-    if (parentStatus) container_status_i[c] = *parentStatus;
-    return parentStatus;
+const PHV::Allocation::ContainerStatus *PHV::Transaction::findStatus(
+    const PHV::Container &c) const {
+    auto it = container_status_i.find(c);
+    if (it != container_status_i.end()) return &it->second;
+    return parent_i->findStatus(c);
 }
 
 PHV::Allocation::FieldStatus PHV::Transaction::getStatus(const PHV::Field *f) const {
-    // DO NOT cache field_status_i like container_status_i because
+    // DO NOT cache field_status_i like container statuses because
     // container_status_i are always modified-by-copy, while this
     // field_status_i are not. This leads to a bug that when field_status_i
     // is modified in a parent transaction, children transactions can
@@ -1019,7 +1054,7 @@ PHV::Allocation::FieldStatus PHV::Transaction::getStatus(const PHV::Field *f) co
 
 void PHV::Transaction::foreach_slice(const PHV::Field *f,
                                      std::function<void(const AllocSlice &)> cb) const {
-    // DO NOT cache field_status_i like container_status_i because
+    // DO NOT cache field_status_i like container statuses because
     // container_status_i are always modified-by-copy, while this
     // field_status_i are not. This leads to a bug that when field_status_i
     // is modified in a parent transaction, children transactions can
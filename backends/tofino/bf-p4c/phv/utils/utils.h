@@ -19,7 +19,9 @@
 #ifndef BACKENDS_TOFINO_BF_P4C_PHV_UTILS_UTILS_H_
 #define BACKENDS_TOFINO_BF_P4C_PHV_UTILS_UTILS_H_
 
+#include <atomic>
 #include <optional>
+#include <vector>
 
 #include "backends/tofino/bf-p4c/ir/bitrange.h"
 #include "backends/tofino/bf-p4c/ir/gress.h"
@@ -179,8 +181,7 @@ class Allocation {
     assoc::hash_map<PHV::Size, ordered_map<ContainerAllocStatus, int>> count_by_status_i;
 
     // For efficiency, these are NOT copied from parent to child.  Changes in
-    // the child are copied back to the parent on commit.  However, parent info
-    // is copied to the child when queried, as a caching optimization.
+    // the child are copied back to the parent on commit.
     mutable ordered_map<PHV::Container, ContainerStatus> container_status_i;
     mutable ordered_map<const PHV::Field *, FieldStatus> field_status_i;
     /// Structure that remembers the actions at which metadata fields need to be initialized for a
@@ -210,6 +211,27 @@ class Allocation {
 
     bool isTrivial;
 
+    /// Incremented whenever a container status is added to or removed from any allocation,
+    /// which invalidates the statuses that transactions cached from their ancestors.  Atomic,
+    /// as sibling transactions may be written by concurrent workers.
+    static std::atomic<uint64_t> status_generation_i;
+
+    /// Sets the status of @p c in this allocation.  All writes to container_status_i go through
+    /// setStatus() or updateStatus(), apart from clearTransactionStatus(), which bumps the
+    /// generation itself.
+    void setStatus(PHV::Container c, const ContainerStatus &status);
+
+    /// @returns the status of @p c, which this allocation must already hold, to be updated in
+    /// place.  Like setStatus() on an existing status, this keeps its address, so the statuses
+    /// that transactions cached stay valid.
+    ContainerStatus &updateStatus(PHV::Container c);
+
+    /// Same as getStatus(), but does not fill any cache, so that concurrent transactions may
+    /// look up a shared ancestor.
+    virtual const ContainerStatus *findStatus(const PHV::Container &c) const {
+        return getStatus(c);
+    }
+
     Allocation(const PhvInfo &phv, const PhvUse &uses, bool isTrivial = false)
         : phv_i(&phv), uses_i(&uses), isTrivial(isTrivial) {}
 
@@ -561,6 +583,21 @@ class ConcreteAllocation : public Allocation {
 class Transaction : public Allocation {
     const Allocation *parent_i;
 
+    /// A container status read from the ancestors, valid while status_generation_i is
+    /// unchanged.
+    struct CachedStatus {
+        const ContainerStatus *status = nullptr;
+        uint64_t generation = 0;
+    };
+
+    /// Container statuses read from the ancestors, indexed by PhvSpec::containerToId.
+    mutable std::vector<CachedStatus> parent_status_cache_i;
+
+    const ContainerStatus *findStatus(const PHV::Container &c) const override;
+
+    /// Set while concurrent workers read this transaction; getStatus() then bypasses the cache.
+    bool concurrent_reads_i = false;
+
  public:
     /// Uniform abstraction for accessing a container state.
     /// @returns the ContainerStatus of this allocation, if present.  Failing
@@ -601,6 +638,17 @@ class Transaction : public Allocation {
     /// Destructor declaration. Does nothing but quiets warnings
     virtual ~Transaction() {}
 
+    Transaction(const Transaction &) = default;
+
+    /// Replaces the container statuses that descendant transactions may have cached.
+    Transaction &operator=(const Transaction &other) {
+        Allocation::operator=(other);
+        parent_i = other.parent_i;
+        parent_status_cache_i = other.parent_status_cache_i;
+        ++status_generation_i;
+        return *this;
+    }
+
     /// Iterate through container-->allocation slices.
     /// @warning not yet implemented.
     const_iterator begin() const override;
@@ -702,6 +750,7 @@ class Transaction : public Allocation {
 
     /// Clears any allocation added to this transaction.
     void clearTransactionStatus() {
+        if (!container_status_i.empty()) ++status_generation_i;
         container_status_i.clear();
         meta_init_points_i.clear();
         init_writes_i.clear();
@@ -716,6 +765,10 @@ class Transaction : public Allocation {
 
     /// Returns the allocation that this transaction is based on.
     const Allocation *getParent() const { return parent_i; }
+
+    /// Allows transactions built on this one to be evaluated concurrently while @p enable is
+    /// set.  The transaction itself must not be written in the meantime.
+    void setConcurrentReads(bool enable) { concurrent_reads_i = enable; }
 };
 
 /// An interface for gathering statistics common across each kind of cluster.
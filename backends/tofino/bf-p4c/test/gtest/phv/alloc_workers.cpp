@@ -0,0 +1,110 @@
+/**
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License.  You may obtain a copy
+ * of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Verify that scoring PHV container groups on several threads (--phv-alloc-workers) picks the
+ * same allocation as scoring them serially.
+ */
+
+#include "backends/tofino/bf-p4c/test/gtest/tofino_gtest_utils.h"
+#include "bf_gtest_helpers.h"
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+#include "test/gtest/helpers.h"
+
+namespace P4::Test {
+
+namespace PhvAllocWorkers {
+
+std::string defines() {
+    return R"(
+    header h_t {
+        bit<8>  a;
+        bit<16> b;
+        bit<32> c;
+        bit<8>  d;
+        bit<4>  e;
+        bit<4>  f;
+    }
+    struct headers_t { h_t h; }
+    struct local_metadata_t {
+        bit<8>  m8;
+        bit<16> m16;
+        bit<32> m32;
+        bit<3>  m3;
+        bit<5>  m5;
+    })";
+}
+
+std::string parser() {
+    return R"(
+    state start {
+        packet.extract(ig_intr_md);
+        packet.advance(PORT_METADATA_SIZE);
+        packet.extract(hdr.h);
+        transition accept;
+    })";
+}
+
+std::string control() {
+    return R"(
+    action set(bit<16> v) {
+        ig_md.m16 = v;
+        ig_md.m3 = hdr.h.e[2:0];
+        ig_md.m5 = hdr.h.f ++ hdr.h.e[0:0];
+    }
+    table t {
+        key = { hdr.h.a : exact; hdr.h.d : ternary; }
+        actions = { set; }
+        size = 256;
+    }
+    apply {
+        t.apply();
+        ig_md.m8 = hdr.h.a + hdr.h.d;
+        ig_md.m32 = hdr.h.c + (bit<32>)ig_md.m16;
+        hdr.h.b = hdr.h.b + ig_md.m16;
+        hdr.h.c = ig_md.m32;
+        hdr.h.d = ig_md.m8 | (bit<8>)ig_md.m3 | (bit<8>)ig_md.m5;
+        ig_tm_md.ucast_egress_port = ig_intr_md.ingress_port;
+    })";
+}
+
+/// @returns the PHV assembly of the test program compiled with @p workers threads.
+std::string phv_asm(int workers) {
+    auto blk = TestCode(TestCode::Hdr::Tofino1arch, TestCode::tofino_shell(),
+                        {defines(), parser(), control(), "apply { packet.emit(hdr); }"});
+    blk.flags(TrimWhiteSpace | TrimAnnotations);
+    BackendOptions().alt_phv_alloc = false;
+    BackendOptions().phv_alloc_workers = workers;
+
+    EXPECT_TRUE(blk.CreateBackend());
+    EXPECT_TRUE(blk.apply_pass(TestCode::Pass::FullBackend));
+    return blk.extract_code(TestCode::CodeBlock::PhvAsm);
+}
+
+}  // namespace PhvAllocWorkers
+
+TEST(PhvAllocWorkers, SameAllocationAsSerial) {
+    auto serial = PhvAllocWorkers::phv_asm(1);
+    ASSERT_NE(serial, "");
+    // Without MULTITHREAD, or once an earlier test has enabled logging, all of them are serial.
+    EXPECT_EQ(PhvAllocWorkers::phv_asm(4), serial);
+    EXPECT_EQ(PhvAllocWorkers::phv_asm(0), serial);
+}
+
+}  // namespace P4::Test
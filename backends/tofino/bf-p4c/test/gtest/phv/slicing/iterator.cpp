@@ -20,7 +20,9 @@
 
 #include "backends/tofino/bf-p4c/device.h"
 #include "backends/tofino/bf-p4c/phv/phv_fields.h"
+#include "backends/tofino/bf-p4c/phv/slicing/phv_slicing_iterator.h"
 #include "backends/tofino/bf-p4c/test/gtest/tofino_gtest_utils.h"
+#include "backends/tofino/bf-p4c/test/utils/super_cluster_builder.h"
 #include "gtest/gtest.h"
 #include "lib/bitvec.h"
 #include "test/gtest/helpers.h"
@@ -139,4 +141,109 @@ TEST_F(TofinoPhvSlicingIterator, make_split_meta) {
     });
 }
 
+namespace {
+
+/// Accepts every packing, so that only the search limits stop a search.
+class AcceptAllActionPacking : public PHV::ActionPackingValidatorInterface {
+ public:
+    Result can_pack(const ordered_set<const PHV::SuperCluster::SliceList *> &,
+                    const ordered_set<const PHV::SuperCluster::SliceList *> &,
+                    const bool) const override {
+        return Result(Result::Code::OK);
+    }
+};
+
+class AcceptAllParserPacking : public PHV::ParserPackingValidatorInterface {
+ public:
+    const PHV::v2::AllocError *can_pack(const PHV::v2::FieldSliceAllocStartMap &,
+                                        bool) const override {
+        return nullptr;
+    }
+};
+
+/// A super cluster of two 8-bit metadata fields in one slice list, well-formed without
+/// any split.
+PHV::SuperCluster *two_byte_cluster() {
+    std::istringstream input(R"(SUPERCLUSTER Uid: 1
+    slice lists:
+        [ ingress::meta.a<8> [0:7]
+          ingress::meta.b<8> [0:7] ]
+    rotational clusters:
+        [[ingress::meta.a<8> [0:7]]]
+        [[ingress::meta.b<8> [0:7]]]
+)");
+    SuperClusterBuilder scb;
+    auto sc = scb.build_super_cluster(input);
+    return sc ? *sc : nullptr;
+}
+
+/// The iterator defaults, see DfsItrContext.
+PHV::Slicing::IteratorConfig default_config() {
+    return PHV::Slicing::IteratorConfig(false, false, true, true, false, (1 << 25), (1 << 19));
+}
+
+/// @returns the slicings of @p sc that the iterator yields with @p config.
+std::vector<std::list<PHV::SuperCluster *>> iterate(const PHV::SuperCluster *sc,
+                                                    const PHV::Slicing::IteratorConfig &config) {
+    PhvInfo phv;
+    MapFieldToParserStates field_to_states(phv);
+    CollectParserInfo parser_info;
+    PHV::Slicing::PHVContainerSizeLayout pa;
+    AcceptAllActionPacking action_packing;
+    AcceptAllParserPacking parser_packing;
+    PHV::Slicing::ItrContext itr(
+        phv, field_to_states, parser_info, sc, pa, action_packing, parser_packing,
+        [](const PHV::FieldSlice &, const PHV::FieldSlice &) { return false; },
+        [](const PHV::Field *) { return true; });
+    itr.set_config(config);
+    std::vector<std::list<PHV::SuperCluster *>> slicings;
+    itr.iterate([&](std::list<PHV::SuperCluster *> slicing) {
+        slicings.push_back(slicing);
+        return true;
+    });
+    return slicings;
+}
+
+}  // namespace
+
+TEST_F(TofinoPhvSlicingIterator, finds_slicings) {
+    auto *sc = two_byte_cluster();
+    ASSERT_NE(sc, nullptr);
+    EXPECT_FALSE(iterate(sc, default_config()).empty());
+}
+
+// A search that spends its step budget before finding a slicing yields the best partial one,
+// here the unsplit super cluster.
+TEST_F(TofinoPhvSlicingIterator, budget_exhausted_yields_partial_slicing) {
+    auto *sc = two_byte_cluster();
+    ASSERT_NE(sc, nullptr);
+    auto config = default_config();
+    config.max_search_steps = 0;
+    auto slicings = iterate(sc, config);
+    ASSERT_EQ(slicings.size(), 1U);
+    ASSERT_EQ(slicings.front().size(), 1U);
+    EXPECT_EQ(slicings.front().front()->slice_lists().size(), 1U);
+}
+
+// The limit of steps per solution is not a budget: a search that reaches it ends without any
+// slicing.
+TEST_F(TofinoPhvSlicingIterator, steps_per_solution_limit_yields_nothing) {
+    auto *sc = two_byte_cluster();
+    ASSERT_NE(sc, nullptr);
+    auto config = default_config();
+    config.max_search_steps_per_solution = 0;
+    EXPECT_TRUE(iterate(sc, config).empty());
+}
+
+// Options override the budgets of the configuration: with a budget of one step, the search
+// yields one slicing, complete or partial, and stops.
+TEST_F(TofinoPhvSlicingIterator, budget_options) {
+    auto *sc = two_byte_cluster();
+    ASSERT_NE(sc, nullptr);
+    BackendOptions().phv_slicing_cluster_max_steps = 1;
+    auto slicings = iterate(sc, default_config());
+    BackendOptions().phv_slicing_cluster_max_steps = 0;
+    EXPECT_EQ(slicings.size(), 1U);
+}
+
 }  // namespace P4::Test
@@ -421,6 +421,51 @@ TEST_F(TofinoPhvCrush, Transaction) {
     EXPECT_EQ(0U, alloc_attempt.slices(c3).size());
 }
 
+TEST_F(TofinoPhvCrush, nestedTransactionReads) {
+    const PhvSpec &phvSpec = Device::phvSpec();
+    PhvInfo phv;
+    PhvUse uses(phv);
+    PHV::ConcreteAllocation alloc(phv, uses);
+
+    PHV::Container c0 = phvSpec.idToContainer(*phvSpec.mauGroups(PHV::Size::b8)[2].min());
+    PHV::Container c1 = phvSpec.idToContainer(*phvSpec.mauGroups(PHV::Size::b32)[3].min());
+
+    PHV::Field f0;
+    f0.id = 0;
+    f0.size = 8;
+    f0.name = "foo.bar"_cs;
+    f0.gress = INGRESS;
+    f0.offset = 0;
+    f0.metadata = true;
+    f0.bridged = false;
+    f0.pov = false;
+    PHV::AllocSlice s0(&f0, c0, 0, 0, 8);
+    PHV::AllocSlice s1(&f0, c1, 0, 0, 8);
+
+    auto outer = alloc.makeTransaction();
+    auto inner = outer.makeTransaction();
+
+    // Reads do not add anything to the transactions.
+    EXPECT_EQ(0U, inner.slices(c0).size());
+    EXPECT_EQ(0U, inner.slices(c1).size());
+    EXPECT_TRUE(inner.getTransactionStatus().empty());
+    EXPECT_TRUE(outer.getTransactionStatus().empty());
+
+    // Writes to the ancestors after a read are visible to the inner transaction.
+    outer.allocate(s0);
+    alloc.allocate(s1);
+    EXPECT_EQ(ordered_set<PHV::AllocSlice>({s0}), inner.slices(c0));
+    EXPECT_EQ(ordered_set<PHV::AllocSlice>({s1}), inner.slices(c1));
+    EXPECT_EQ(0U, outer.getTransactionStatus().count(c1));
+
+    // Once the outer transaction is committed, reads go to the allocation.
+    alloc.commit(outer);
+    EXPECT_TRUE(outer.getTransactionStatus().empty());
+    EXPECT_EQ(ordered_set<PHV::AllocSlice>({s0}), alloc.slices(c0));
+    EXPECT_EQ(ordered_set<PHV::AllocSlice>({s0}), inner.slices(c0));
+    EXPECT_EQ(ordered_set<PHV::AllocSlice>({s1}), inner.slices(c1));
+}
+
 TEST_F(TofinoPhvCrush, slicesByLiveness) {
     const PhvSpec &phvSpec = Device::phvSpec();
 
@@ -0,0 +1,36 @@
+# Compiles a two-pipe program sequentially and with --parallel-pipes, and checks that both
+# compilations succeed and produce the same assembly for each pipe.
+#
+# Usage: cmake -DCOMPILER=<p4c-barefoot> -DSOURCE=<program.p4> -DWORK_DIR=<dir>
+#              -P parallel_pipes.cmake
+
+get_filename_component(program ${SOURCE} NAME_WE)
+file(REMOVE_RECURSE ${WORK_DIR})
+
+foreach(mode sequential parallel)
+  set(args)
+  if (mode STREQUAL "parallel")
+    set(args --parallel-pipes)
+  endif()
+  execute_process(
+    COMMAND ${COMPILER} ${args} -o ${WORK_DIR}/${mode} ${SOURCE}
+    RESULT_VARIABLE result)
+  if (NOT result EQUAL 0)
+    message(FATAL_ERROR "${mode} compilation failed: ${result}")
+  endif()
+endforeach()
+
+foreach(pipe pipe1 pipe2)
+  foreach(mode sequential parallel)
+    set(bfa ${WORK_DIR}/${mode}/${pipe}/${program}.bfa)
+    if (NOT EXISTS ${bfa})
+      message(FATAL_ERROR "${mode} compilation did not write ${bfa}")
+    endif()
+    # The run id differs between compilations.
+    file(STRINGS ${bfa} ${mode}_asm)
+    list(FILTER ${mode}_asm EXCLUDE REGEX "run_id:")
+  endforeach()
+  if (NOT sequential_asm STREQUAL parallel_asm)
+    message(FATAL_ERROR "${pipe}: parallel assembly differs from the sequential one")
+  endif()
+endforeach()
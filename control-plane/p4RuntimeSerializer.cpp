@@ -18,8 +18,12 @@ limitations under the License.
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/json_util.h>
+#include <google/protobuf/util/type_resolver_util.h>
 #pragma GCC diagnostic pop
 
 #include <iostream>
@@ -117,13 +121,31 @@ static bool writeJsonTo(const Message &message, std::ostream *destination,
     using namespace google::protobuf::util;
     CHECK_NULL(destination);
 
-    std::string output;
-    if (!MessageToJsonString(message, &output, options).ok()) {
+    // This is what MessageToJsonString does internally, except that the JSON
+    // text, which is several times larger than the binary encoding, is written
+    // to @destination as it is produced instead of being built in memory.
+    static TypeResolver *resolver = NewTypeResolverForDescriptorPool(
+        "type.googleapis.com", google::protobuf::DescriptorPool::generated_pool());
+    std::string binary;
+    if (!message.SerializeToString(&binary)) {
+        ::P4::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to JSON");
+        return false;
+    }
+    bool ok;
+    {
+        google::protobuf::io::ArrayInputStream input(binary.data(),
+                                                     static_cast<int>(binary.size()));
+        google::protobuf::io::OstreamOutputStream output(destination);
+        ok = BinaryToJsonStream(resolver,
+                                "type.googleapis.com/" + message.GetDescriptor()->full_name(),
+                                &input, &output, options)
+                 .ok();
+    }
+    if (!ok) {
         ::P4::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to JSON");
         return false;
     }
 
-    *destination << output;
     if (!destination->good()) {
         ::P4::error(ErrorType::ERR_IO, "Failed to write JSON protobuf message to the output");
         return false;
@@ -138,21 +160,22 @@ static bool writeJsonTo(const Message &message, std::ostream *destination,
 static bool writeTextTo(const Message &message, std::ostream *destination) {
     CHECK_NULL(destination);
 
-    // According to the protobuf documentation, it would be better to use Print
-    // with a FileOutputStream object for performance reasons. However all we
-    // have here is a std::ostream and performance is not a concern.
-    std::string output;
     google::protobuf::TextFormat::Printer textPrinter;
     // set to expand google.protobuf.Any payloads
     textPrinter.SetExpandAny(true);
     *destination << "# proto-file: " << message.GetDescriptor()->file()->name() << "\n";
     *destination << "# proto-message: " << message.GetTypeName() << "\n\n";
-    if (!textPrinter.PrintToString(message, &output)) {
+    bool ok;
+    {
+        // Print straight to the stream rather than building the text in memory.
+        google::protobuf::io::OstreamOutputStream output(destination);
+        ok = textPrinter.Print(message, &output);
+    }
+    if (!ok) {
         ::P4::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to text");
         return false;
     }
 
-    *destination << output;
     if (!destination->good()) {
         ::P4::error(ErrorType::ERR_IO, "Failed to write text protobuf message to the output");
         return false;
@@ -514,13 +537,16 @@ class P4RuntimeAnalyzer {
      * handles architecture-specific constructs (e.g. externs).
      * @param arch  The name of the P4_16 architecture the program was written
      * against.
+     * @param withEntries  Whether to convert the static table entries; if
+     * false, the returned WriteRequest is empty and the entries are not
+     * checked.
      * @return a P4Info message representing the program's control plane API.
      *         Never returns null.
      */
     static P4RuntimeAPI analyze(const IR::P4Program *program,
                                 const IR::ToplevelBlock *evaluatedProgram, ReferenceMap *refMap,
                                 TypeMap *typeMap, P4RuntimeArchHandlerIface *archHandler,
-                                cstring arch);
+                                cstring arch, bool withEntries);
 
     void addAction(const IR::P4Action *actionDeclaration) {
         if (isHidden(actionDeclaration)) return;
@@ -1403,7 +1429,7 @@ class P4RuntimeEntriesConverter {
                                                      const IR::ToplevelBlock *evaluatedProgram,
                                                      ReferenceMap *refMap, TypeMap *typeMap,
                                                      P4RuntimeArchHandlerIface *archHandler,
-                                                     cstring arch) {
+                                                     cstring arch, bool withEntries) {
     using namespace ControlPlaneAPI;
 
     CHECK_NULL(archHandler);
@@ -1449,16 +1475,18 @@ class P4RuntimeEntriesConverter {
     analyzer.addPkgInfo(evaluatedProgram, arch);
 
     P4RuntimeEntriesConverter entriesConverter(*symbols);
-    Helpers::forAllEvaluatedBlocks(evaluatedProgram, [&](const IR::Block *block) {
-        if (block->is<IR::TableBlock>())
-            entriesConverter.addTableEntries(block->to<IR::TableBlock>(), refMap, typeMap,
-                                             archHandler);
-        else if (block->is<IR::ExternBlock>()) {
-            // add entries for arch specific extern types
-            archHandler->addExternEntries(entriesConverter.getEntries(), *symbols,
-                                          block->to<IR::ExternBlock>());
-        }
-    });
+    if (withEntries) {
+        Helpers::forAllEvaluatedBlocks(evaluatedProgram, [&](const IR::Block *block) {
+            if (block->is<IR::TableBlock>())
+                entriesConverter.addTableEntries(block->to<IR::TableBlock>(), refMap, typeMap,
+                                                 archHandler);
+            else if (block->is<IR::ExternBlock>()) {
+                // add entries for arch specific extern types
+                archHandler->addExternEntries(entriesConverter.getEntries(), *symbols,
+                                              block->to<IR::ExternBlock>());
+            }
+        });
+    }
 
     auto *p4Info = analyzer.getP4Info();
     auto *p4Entries = entriesConverter.getEntries();
@@ -1467,7 +1495,8 @@ class P4RuntimeEntriesConverter {
 
 }  // namespace ControlPlaneAPI
 
-P4RuntimeAPI P4RuntimeSerializer::generateP4Runtime(const IR::P4Program *program, cstring arch) {
+P4RuntimeAPI P4RuntimeSerializer::generateP4Runtime(const IR::P4Program *program, cstring arch,
+                                                    bool withEntries) {
     using namespace ControlPlaneAPI;
 
     auto archHandlerBuilderIt = archHandlerBuilders.find(arch);
@@ -1500,7 +1529,7 @@ P4RuntimeAPI P4RuntimeSerializer::generateP4Runtime(const IR::P4Program *program
     auto archHandler = (*archHandlerBuilderIt->second)(&refMap, &typeMap, evaluatedProgram);
 
     return P4RuntimeAnalyzer::analyze(p4RuntimeProgram, evaluatedProgram, &refMap, &typeMap,
-                                      archHandler, arch);
+                                      archHandler, arch, withEntries);
 }
 
 void P4RuntimeAPI::serializeP4InfoTo(std::ostream *destination, P4RuntimeFormat format) const {
@@ -1594,6 +1623,8 @@ void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const IR::P4Program *prog
     auto arch = P4RuntimeSerializer::resolveArch(options);
     if (Log::verbose())
         std::cout << "Generating P4Runtime output for architecture " << arch << std::endl;
+    // The entries are converted even if they are not written, as that is where invalid static
+    // entries are diagnosed.
     auto p4Runtime = get()->generateP4Runtime(program, arch);
     serializeP4RuntimeIfRequired(p4Runtime, options);
 }
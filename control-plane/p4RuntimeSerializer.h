@@ -104,9 +104,15 @@ class P4RuntimeSerializer {
      *
      * @param program  The program to construct the control-plane API from. All
      *                 frontend passes must have already run.
+     * @param withEntries  Whether to convert the program's static table
+     *                     entries. If false, the API has no entries and
+     *                     invalid entries are not diagnosed, so only pass
+     *                     false when P4Info is all that is needed and the
+     *                     entries are checked elsewhere.
      * @return the generated P4Runtime API.
      */
-    P4RuntimeAPI generateP4Runtime(const IR::P4Program *program, cstring arch);
+    P4RuntimeAPI generateP4Runtime(const IR::P4Program *program, cstring arch,
+                                   bool withEntries = true);
 
     /**
      * A convenience wrapper for P4::generateP4Runtime() which generates the
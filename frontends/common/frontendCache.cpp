@@ -0,0 +1,226 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "frontends/common/frontendCache.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <system_error>
+
+#include "absl/strings/str_format.h"
+#include "frontends/common/parseInput.h"
+#include "ir/ir.h"
+#include "ir/json_generator.h"
+#include "ir/json_loader.h"
+#include "lib/compile_context.h"
+#include "lib/hash.h"
+#include "lib/log.h"
+
+namespace P4 {
+
+/// Stands in for the output stream of an ErrorReporter, passing everything through to the
+/// original stream while keeping a copy.
+class FrontendCache::DiagnosticRecorder : public std::streambuf {
+    ErrorReporter &reporter;
+    std::ostream *original;
+    std::ostream tee;
+
+ protected:
+    int overflow(int c) override {
+        if (c != traits_type::eof()) {
+            original->put(static_cast<char>(c));
+            recorded.push_back(static_cast<char>(c));
+        }
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char *s, std::streamsize n) override {
+        original->write(s, n);
+        recorded.append(s, n);
+        return n;
+    }
+    int sync() override {
+        original->flush();
+        return 0;
+    }
+
+ public:
+    std::string recorded;
+
+    explicit DiagnosticRecorder(ErrorReporter &reporter)
+        : reporter(reporter), original(reporter.getOutputStream()), tee(this) {
+        reporter.setOutputStream(&tee);
+    }
+    ~DiagnosticRecorder() override { reporter.setOutputStream(original); }
+};
+
+/// Reads the whole of @p file into @p text.
+static void readAll(FILE *file, std::string &text) {
+    char buf[64 * 1024];
+    while (size_t n = fread(buf, 1, sizeof(buf), file)) text.append(buf, n);
+}
+
+std::optional<FrontendCache> FrontendCache::open(const CompilerOptions &options) {
+    if (options.frontendCacheDir.empty()) return std::nullopt;
+
+    std::string text;
+    if (options.doNotPreprocess) {
+        FILE *file = fopen(options.file.c_str(), "r");
+        if (file == nullptr) return std::nullopt;
+        readAll(file, text);
+        fclose(file);
+    } else {
+        auto preprocessorResult = options.preprocess();
+        if (::P4::errorCount() > 0 || !preprocessorResult.has_value()) return std::nullopt;
+        readAll(preprocessorResult.value().get(), text);
+    }
+
+    uint64_t key = Util::hash_combine(Util::hash(text), Util::hash(configuration(options)));
+    auto entry = options.frontendCacheDir / absl::StrFormat("%016x-%x.p4ir", key, text.size());
+    LOG2("Front end cache entry for " << options.file << ": " << entry);
+    // A hit would skip the passes that write these outputs.
+    bool bypass = !options.prettyPrintFile.empty() || !options.top4.empty() ||
+                  options.listFrontendPasses;
+    return FrontendCache(entry, std::move(text), bypass);
+}
+
+std::string FrontendCache::configuration(const CompilerOptions &options) {
+    std::stringstream config;
+    config << options.exe_name << '\n'
+           << options.compilerVersion << '\n'
+           << static_cast<int>(options.langVersion) << '\n'
+           << options.target << '\n'
+           << options.arch << '\n'
+           << options.optimizationLevel << options.optimizeDebug << options.optimizeSize << '\n'
+           << options.optimizeParserInlining << options.controlPlaneAPIGenEnabled() << '\n';
+    if (options.excludeFrontendPasses) {
+        for (auto pass : options.passesToExcludeFrontend) config << pass << ' ';
+    }
+    config << '\n';
+    // Diagnostic actions, which decide whether the front end fails, and disabled annotations
+    // are only kept in the compile context or privately, so they are taken from the command
+    // line. Their optional argument is always attached with '='.
+    std::istringstream command(options.getCompileCommand().string());
+    for (std::string arg; command >> arg;) {
+        if (arg.rfind("--W", 0) == 0 || arg.rfind("--disable-annotations", 0) == 0)
+            config << arg << ' ';
+    }
+    return config.str();
+}
+
+const IR::P4Program *FrontendCache::parse(const CompilerOptions &options) const {
+    std::istringstream input(text);
+    const auto *result =
+        options.isv1() ? parseV1Program<std::istringstream &>(input, options.file.string(), 1,
+                                                              options.getDebugHook())
+                       : P4ParserDriver::parse(input, options.file.string());
+    if (::P4::errorCount() > 0) {
+        ::P4::error(ErrorType::ERR_OVERLIMIT, "%1% errors encountered, aborting compilation",
+                    ::P4::errorCount());
+        return nullptr;
+    }
+    BUG_CHECK(result != nullptr, "Parsing failed, but we didn't report an error");
+    return result;
+}
+
+std::filesystem::path FrontendCache::diagnosticsPath() const {
+    auto path = entry;
+    path += ".diag";
+    return path;
+}
+
+const IR::P4Program *FrontendCache::load() const {
+    if (bypass) {
+        LOG1("Front end cache bypassed, the front end produces output: " << entry);
+        return nullptr;
+    }
+    std::ifstream in(entry, std::ios::binary);
+    // The diagnostics are stored before the entry, so an entry without them was damaged.
+    std::ifstream diagnostics(diagnosticsPath(), std::ios::binary);
+    if (!in || !diagnostics) {
+        LOG1("Front end cache miss: " << entry);
+        return nullptr;
+    }
+    const IR::Node *node = nullptr;
+    try {
+        JSONLoader loader(in);
+        loader >> node;
+    } catch (const std::exception &e) {
+        LOG1("Ignoring unreadable front end cache entry " << entry << ": " << e.what());
+        return nullptr;
+    }
+    const auto *program = node ? node->to<IR::P4Program>() : nullptr;
+    if (program == nullptr) {
+        LOG1("Ignoring front end cache entry " << entry << ": not a P4Program");
+        return nullptr;
+    }
+    LOG1("Front end cache hit: " << entry);
+    std::string text(std::istreambuf_iterator<char>(diagnostics), {});
+    auto *out = BaseCompileContext::get().errorReporter().getOutputStream();
+    *out << text;
+    out->flush();
+    return program;
+}
+
+void FrontendCache::record() {
+    recorder.reset();
+    recorder = std::make_shared<DiagnosticRecorder>(BaseCompileContext::get().errorReporter());
+}
+
+/// Writes @p file through a temporary file, calling @p write to produce its contents.
+/// @returns false if it could not be written.
+template <typename Write>
+static bool writeAtomically(const std::filesystem::path &file, Write write) {
+    std::error_code ec;
+    auto tmp = file;
+    tmp += absl::StrFormat(".tmp%d", getpid());
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out) {
+            LOG1("Cannot write front end cache entry " << tmp);
+            return false;
+        }
+        write(out);
+        if (!out.flush()) {
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, file, ec);
+    if (ec) {
+        LOG1("Cannot store front end cache entry " << file << ": " << ec.message());
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+void FrontendCache::store(const IR::P4Program *program) {
+    std::string diagnostics = recorder ? recorder->recorded : std::string();
+    recorder.reset();
+    std::error_code ec;
+    std::filesystem::create_directories(entry.parent_path(), ec);
+    if (!writeAtomically(diagnosticsPath(), [&](std::ostream &out) { out << diagnostics; }))
+        return;
+    writeAtomically(entry, [&](std::ostream &out) {
+        JSONGenerator(out, true, JSONGenerator::Encoding::Binary).emit(program);
+    });
+}
+
+}  // namespace P4
@@ -0,0 +1,91 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef FRONTENDS_COMMON_FRONTENDCACHE_H_
+#define FRONTENDS_COMMON_FRONTENDCACHE_H_
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "frontends/common/options.h"
+
+namespace P4::IR {
+class P4Program;
+}  // namespace P4::IR
+
+namespace P4 {
+
+/// An opt-in on-disk cache of front-end results, enabled with `--frontend-cache <dir>`.
+/// Each entry holds the IR produced by the front end, serialized with the binary encoding of
+/// JSONGenerator, and is keyed by a hash of the preprocessed input together with the compiler
+/// name, version and the options that influence parsing and the front end.  On a hit, the
+/// driver skips parsing and the front end and resumes compilation at the mid end.  The
+/// diagnostics that the front end emitted when the entry was created are stored with it and
+/// reported again on a hit.  Options that make the front end itself produce output (`--pp`,
+/// `--top4`, `--listFrontendPasses`) turn every lookup into a miss, so that the front end runs.
+class FrontendCache {
+    class DiagnosticRecorder;
+
+    std::filesystem::path entry;
+    /// The preprocessed input, kept so that a miss does not run the preprocessor again.
+    std::string text;
+    /// True if the options ask for output of the front end, which a hit would not produce.
+    bool bypass;
+    /// Copies the diagnostics reported since record() was called.
+    std::shared_ptr<DiagnosticRecorder> recorder;
+
+    FrontendCache(std::filesystem::path entry, std::string text, bool bypass)
+        : entry(std::move(entry)), text(std::move(text)), bypass(bypass) {}
+
+    /// The file that holds the diagnostics of this entry.
+    std::filesystem::path diagnosticsPath() const;
+
+ public:
+    /// @returns the cache entry for the input described by @p options, or std::nullopt if the
+    /// cache is disabled or the input cannot be read.  Computing the key runs the preprocessor.
+    static std::optional<FrontendCache> open(const CompilerOptions &options);
+
+    /// @returns everything besides the source text that the key depends on.  Options that only
+    /// select outputs, such as dump or output files, are left out.
+    static std::string configuration(const CompilerOptions &options);
+
+    /// The file that holds this entry.
+    const std::filesystem::path &path() const { return entry; }
+
+    /// True if the options ask for output of the front end, so load() always misses.
+    bool bypassed() const { return bypass; }
+
+    /// Parses the input that the key was computed from, as parseP4File would, without running
+    /// the preprocessor again.
+    const IR::P4Program *parse(const CompilerOptions &options) const;
+
+    /// @returns the cached front-end output, or nullptr if there is no usable entry or the
+    /// cache is bypassed.  On a hit, the stored diagnostics are reported again.
+    const IR::P4Program *load() const;
+
+    /// Starts recording the diagnostics reported to the current compile context, which are
+    /// still emitted as usual.  Call it before parsing on a miss; store() saves them.
+    void record();
+
+    /// Stores @p program as the front-end output for this entry, together with the diagnostics
+    /// recorded since record(), and stops recording.  The entry is written to a temporary file
+    /// first, so concurrent compilations never observe a partial entry.
+    void store(const IR::P4Program *program);
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_FRONTENDCACHE_H_ */
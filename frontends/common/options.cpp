@@ -17,6 +17,7 @@ limitations under the License.
 #include "options.h"
 
 #include "frontends/p4/frontend.h"
+#include "ir/pass_profile.h"
 
 namespace P4 {
 
@@ -73,6 +74,24 @@ CompilerOptions::CompilerOptions(std::string_view defaultMessage) : ParserOption
             return true;
         },
         "[Compiler debugging] Dump and undump the IR");
+    registerOption(
+        "--frontend-cache", "dir",
+        [this](const char *arg) {
+            frontendCacheDir = arg;
+            return true;
+        },
+        "Cache the output of the front end in the specified directory, keyed by the\n"
+        "preprocessed input and compiler options, and reuse it when compiling the same\n"
+        "input again. Supported by p4test and p4c-bm2-ss.");
+    registerOption(
+        "--pass-profile", "file",
+        [](const char *arg) {
+            PassProfiler::enable(arg);
+            return true;
+        },
+        "[Compiler debugging] Record the wall time, CPU time, allocated bytes and created IR\n"
+        "nodes of every pass. Writes a Chrome trace-event file and prints the most expensive\n"
+        "passes on exit.");
     registerOption(
         "--pp", "file",
         [this](const char *arg) {
@@ -59,6 +59,8 @@ class CompilerOptions : public ParserOptions {
     std::filesystem::path dumpJsonFile;
     // Dump and undump the IR tree.
     bool debugJson = false;
+    // Directory used to cache front-end results between compilations (disabled if empty).
+    std::filesystem::path frontendCacheDir;
     // if this flag is true, compile program in non-debug mode.
     bool ndebug = false;
     // Write a P4Runtime control plane API description to the specified file.
@@ -30,6 +30,7 @@ limitations under the License.
 
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_format.h"
+#include "frontends/common/preprocessor.h"
 #include "frontends/p4/toP4/toP4.h"
 #include "lib/exceptions.h"
 #include "lib/exename.h"
@@ -199,6 +200,15 @@ ParserOptions::ParserOptions(std::string_view defaultMessage) : Util::Options(de
             return true;
         },
         "Skip preprocess, assume input file is already preprocessed.");
+    registerOption(
+        "--integrated-cpp", nullptr,
+        [this](const char *) {
+            integratedPreprocessor = true;
+            return true;
+        },
+        "Preprocess in the compiler instead of running cpp. Falls back to cpp for\n"
+        "input that uses function-like macros, #error, #line and other features\n"
+        "the integrated preprocessor does not support.");
     registerOption(
         "--disable-annotations", "annotations",
         [this](const char *arg) {
@@ -405,11 +415,39 @@ const char *ParserOptions::getIncludePath() const {
     return path.c_str();
 }
 
+static void closeTemporaryFile(FILE *file) {
+    if (file != nullptr) fclose(file);
+}
+
+/// Runs the integrated preprocessor and returns its output in a temporary file, or nullptr if
+/// the input needs the external preprocessor.
+static FILE *preprocessInProcess(const ParserOptions &options) {
+    Preprocessor preprocessor;
+    if (!preprocessor.addOptions(options.preprocessor_options.string_view()) ||
+        !preprocessor.addOptions(options.getIncludePath())) {
+        return nullptr;
+    }
+    auto text = preprocessor.process(options.file);
+    if (!text) return nullptr;
+    FILE *result = tmpfile();
+    if (result == nullptr) return nullptr;
+    if (fwrite(text->data(), 1, text->size(), result) != text->size()) {
+        fclose(result);
+        return nullptr;
+    }
+    rewind(result);
+    return result;
+}
+
 std::optional<ParserOptions::PreprocessorResult> ParserOptions::preprocess() const {
     FILE *in = nullptr;
+    auto close = &closeFile;
 
     if (file == "-") {
         in = stdin;
+    } else if (integratedPreprocessor && (in = preprocessInProcess(*this)) != nullptr) {
+        if (Log::verbose()) std::cerr << "Preprocessed " << file << " in process" << std::endl;
+        close = &closeTemporaryFile;
     } else {
 #ifdef __clang__
         std::string cmd("cc -E -x c -Wno-comment");
@@ -439,7 +477,7 @@ std::optional<ParserOptions::PreprocessorResult> ParserOptions::preprocess() con
         }
         return std::nullopt;
     }
-    return ParserOptions::PreprocessorResult(in, &closeFile);
+    return ParserOptions::PreprocessorResult(in, close);
 }
 
 // From (folder, file.ext, suffix)  returns
@@ -87,6 +87,8 @@ class ParserOptions : public Util::Options {
     cstring compilerVersion;
     /// if true skip preprocess
     bool doNotPreprocess = false;
+    /// if true preprocess in process when the input allows it, instead of running cpp
+    bool integratedPreprocessor = false;
     /// substrings matched against pass names
     std::vector<cstring> top4;
     /// debugging dumps of programs written in this folder
@@ -0,0 +1,605 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "frontends/common/preprocessor.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+namespace P4 {
+
+namespace {
+
+/// Thrown for input that the integrated preprocessor does not handle.
+struct Unsupported {};
+
+/// Maximum nesting of #include; cpp has the same limit.
+constexpr unsigned maxIncludeDepth = 200;
+
+bool isIdentifierStart(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+
+bool isIdentifierChar(char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+
+bool isOperatorChar(char c) { return c != '\0' && std::strchr("+-*/%<>=&|!^.:#", c) != nullptr; }
+
+/// @returns true if @p a followed by @p b would be read as a single token.
+bool wouldPaste(char a, char b) {
+    return (isIdentifierChar(a) && isIdentifierChar(b)) || (isOperatorChar(a) && isOperatorChar(b));
+}
+
+std::string_view trim(std::string_view text) {
+    auto begin = text.find_first_not_of(" \t\r\f\v");
+    if (begin == std::string_view::npos) return {};
+    auto end = text.find_last_not_of(" \t\r\f\v");
+    return text.substr(begin, end - begin + 1);
+}
+
+/// @returns the length of the identifier at the start of @p text, or 0 if there is none.
+size_t identifierLength(std::string_view text) {
+    if (text.empty() || !isIdentifierStart(text[0])) return 0;
+    size_t length = 1;
+    while (length < text.size() && isIdentifierChar(text[length])) ++length;
+    return length;
+}
+
+/// @returns the length of the string literal at the start of @p text, or npos if it is not
+/// terminated on this line.
+size_t stringLength(std::string_view text) {
+    for (size_t i = 1; i < text.size(); ++i) {
+        if (text[i] == '\\') {
+            ++i;
+        } else if (text[i] == '"') {
+            return i + 1;
+        }
+    }
+    return std::string_view::npos;
+}
+
+/// Replaces each comment in the text of a directive by a space.
+std::string stripComments(std::string_view text) {
+    std::string result;
+    for (size_t i = 0; i < text.size();) {
+        if (text.compare(i, 2, "//") == 0) break;
+        if (text.compare(i, 2, "/*") == 0) {
+            auto end = text.find("*/", i + 2);
+            if (end == std::string_view::npos) throw Unsupported();
+            result += ' ';
+            i = end + 2;
+        } else if (text[i] == '"') {
+            auto length = stringLength(text.substr(i));
+            if (length == std::string_view::npos) throw Unsupported();
+            result.append(text.substr(i, length));
+            i += length;
+        } else {
+            result += text[i++];
+        }
+    }
+    return result;
+}
+
+/// Tracks block comments through a line in a skipped conditional group.
+void skipLine(std::string_view text, bool &inComment) {
+    for (size_t i = 0; i < text.size();) {
+        if (inComment) {
+            auto end = text.find("*/", i);
+            if (end == std::string_view::npos) return;
+            inComment = false;
+            i = end + 2;
+        } else if (text.compare(i, 2, "//") == 0) {
+            return;
+        } else if (text.compare(i, 2, "/*") == 0) {
+            inComment = true;
+            i += 2;
+        } else if (text[i] == '"') {
+            auto length = stringLength(text.substr(i));
+            if (length == std::string_view::npos) return;
+            i += length;
+        } else {
+            ++i;
+        }
+    }
+}
+
+/// @returns the text after the '#' of a directive line, or std::nullopt if @p line is not a
+/// directive.
+std::optional<std::string_view> directiveText(std::string_view line) {
+    auto start = line.find_first_not_of(" \t\f\v");
+    if (start == std::string_view::npos) return std::nullopt;
+    if (line[start] == '#') return line.substr(start + 1);
+    // cpp also accepts a directive after a comment, which is not worth supporting.
+    if (line.compare(start, 2, "/*") == 0) {
+        auto end = line.find("*/", start + 2);
+        if (end != std::string_view::npos) {
+            auto next = line.find_first_not_of(" \t\f\v", end + 2);
+            if (next != std::string_view::npos && line[next] == '#') throw Unsupported();
+        }
+    }
+    return std::nullopt;
+}
+
+/// Macros that cpp defines itself; their values cannot be reproduced exactly.
+bool isBuiltinMacro(std::string_view name) {
+    static const char *const builtins[] = {
+        "__FILE__",    "__LINE__",          "__DATE__",      "__TIME__",
+        "__COUNTER__", "__INCLUDE_LEVEL__", "__BASE_FILE__", "__TIMESTAMP__"};
+    for (const char *builtin : builtins) {
+        if (name == builtin) return true;
+    }
+    return false;
+}
+
+/// Evaluates the integer constant expression of an #if directive after macro expansion. All
+/// remaining identifiers evaluate to 0.
+class ConditionEvaluator {
+    std::vector<std::string> tokens;
+    std::vector<intmax_t> values;
+    size_t position = 0;
+
+    static constexpr const char *twoCharOperators[] = {"<<", ">>", "<=", ">=",
+                                                       "==", "!=", "&&", "||"};
+    /// Binary operators from lowest to highest precedence.
+    static constexpr const char *binaryOperators[][4] = {
+        {"||"}, {"&&"}, {"|"}, {"^"}, {"&"}, {"==", "!="}, {"<", "<=", ">", ">="},
+        {"<<", ">>"}, {"+", "-"}, {"*", "/", "%"}};
+    static constexpr size_t levels = sizeof(binaryOperators) / sizeof(binaryOperators[0]);
+
+    void tokenize(std::string_view text) {
+        for (size_t i = 0; i < text.size();) {
+            char c = text[i];
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                ++i;
+            } else if (std::isdigit(static_cast<unsigned char>(c))) {
+                size_t end = i;
+                while (end < text.size() && isIdentifierChar(text[end])) ++end;
+                std::string literal(text.substr(i, end - i));
+                while (!literal.empty() && std::strchr("uUlL", literal.back()) != nullptr)
+                    literal.pop_back();
+                char *rest = nullptr;
+                errno = 0;
+                auto value = std::strtoull(literal.c_str(), &rest, 0);
+                if (errno != 0 || *rest != '\0') throw Unsupported();
+                tokens.emplace_back("0");
+                values.push_back(static_cast<intmax_t>(value));
+                i = end;
+            } else if (auto length = identifierLength(text.substr(i))) {
+                tokens.emplace_back("0");
+                values.push_back(0);
+                i += length;
+            } else {
+                size_t operatorLength = 1;
+                for (const char *op : twoCharOperators) {
+                    if (text.compare(i, 2, op) == 0) operatorLength = 2;
+                }
+                if (operatorLength == 1 && std::strchr("+-*/%<>&|^!~()?:", c) == nullptr)
+                    throw Unsupported();
+                tokens.emplace_back(text.substr(i, operatorLength));
+                values.push_back(0);
+                i += operatorLength;
+            }
+        }
+    }
+
+    bool accept(const char *op) {
+        if (position < tokens.size() && tokens[position] == op) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const char *op) {
+        if (!accept(op)) throw Unsupported();
+    }
+
+    static intmax_t apply(std::string_view op, intmax_t left, intmax_t right) {
+        if (op == "||") return left || right;
+        if (op == "&&") return left && right;
+        if (op == "|") return left | right;
+        if (op == "^") return left ^ right;
+        if (op == "&") return left & right;
+        if (op == "==") return left == right;
+        if (op == "!=") return left != right;
+        if (op == "<") return left < right;
+        if (op == "<=") return left <= right;
+        if (op == ">") return left > right;
+        if (op == ">=") return left >= right;
+        if (op == "+") return static_cast<intmax_t>(static_cast<uintmax_t>(left) + right);
+        if (op == "-") return static_cast<intmax_t>(static_cast<uintmax_t>(left) - right);
+        if (op == "*") return static_cast<intmax_t>(static_cast<uintmax_t>(left) * right);
+        if (op == "<<" || op == ">>") {
+            if (right < 0 || right >= 64) throw Unsupported();
+            return op == "<<" ? static_cast<intmax_t>(static_cast<uintmax_t>(left) << right)
+                              : left >> right;
+        }
+        if (right == 0 || (left == INTMAX_MIN && right == -1)) throw Unsupported();
+        return op == "/" ? left / right : left % right;
+    }
+
+    intmax_t parseUnary() {
+        if (accept("!")) return !parseUnary();
+        if (accept("~")) return ~parseUnary();
+        if (accept("-")) return static_cast<intmax_t>(0 - static_cast<uintmax_t>(parseUnary()));
+        if (accept("+")) return parseUnary();
+        if (accept("(")) {
+            auto value = parseConditional();
+            expect(")");
+            return value;
+        }
+        if (position < tokens.size() && tokens[position] == "0") return values[position++];
+        throw Unsupported();
+    }
+
+    intmax_t parseBinary(size_t level) {
+        if (level == levels) return parseUnary();
+        auto left = parseBinary(level + 1);
+        for (bool matched = true; matched;) {
+            matched = false;
+            for (const char *op : binaryOperators[level]) {
+                if (op != nullptr && accept(op)) {
+                    left = apply(op, left, parseBinary(level + 1));
+                    matched = true;
+                    break;
+                }
+            }
+        }
+        return left;
+    }
+
+    intmax_t parseConditional() {
+        auto condition = parseBinary(0);
+        if (!accept("?")) return condition;
+        auto ifTrue = parseConditional();
+        expect(":");
+        auto ifFalse = parseConditional();
+        return condition ? ifTrue : ifFalse;
+    }
+
+ public:
+    bool evaluate(std::string_view text) {
+        tokenize(text);
+        auto value = parseConditional();
+        if (position != tokens.size()) throw Unsupported();
+        return value != 0;
+    }
+};
+
+}  // namespace
+
+void Preprocessor::addIncludeDir(std::filesystem::path dir) {
+    auto name = dir.string();
+    while (name.size() > 1 && name.back() == '/') name.pop_back();
+    includeDirs.push_back(std::move(name));
+}
+
+bool Preprocessor::define(std::string_view definition) {
+    auto equals = definition.find('=');
+    auto name = definition.substr(0, equals);
+    if (name.empty() || identifierLength(name) != name.size()) return false;
+    auto value = equals == std::string_view::npos ? "1" : definition.substr(equals + 1);
+    if (value.find("##") != std::string_view::npos) return false;
+    macros[std::string(name)] = std::string(trim(value));
+    return true;
+}
+
+void Preprocessor::undefine(std::string_view name) { macros.erase(std::string(name)); }
+
+bool Preprocessor::addOptions(std::string_view options) {
+    while (!options.empty()) {
+        auto start = options.find_first_not_of(" \t\n");
+        if (start == std::string_view::npos) break;
+        auto end = options.find_first_of(" \t\n", start);
+        auto option = options.substr(start, end == std::string_view::npos ? end : end - start);
+        options = end == std::string_view::npos ? std::string_view() : options.substr(end);
+        if (option.size() <= 2 || option.find_first_of("\"'\\") != std::string_view::npos)
+            return false;
+        auto argument = option.substr(2);
+        if (option.substr(0, 2) == "-I") {
+            addIncludeDir(argument);
+        } else if (option.substr(0, 2) == "-D") {
+            if (!define(argument)) return false;
+        } else if (option.substr(0, 2) == "-U") {
+            undefine(argument);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string Preprocessor::expand(std::string_view text, bool &inComment,
+                                 std::set<std::string> &disabled) const {
+    std::string result;
+    for (size_t i = 0; i < text.size();) {
+        if (inComment) {
+            auto end = text.find("*/", i);
+            if (end == std::string_view::npos) {
+                result.append(text.substr(i));
+                break;
+            }
+            result.append(text.substr(i, end + 2 - i));
+            inComment = false;
+            i = end + 2;
+            continue;
+        }
+        char c = text[i];
+        if (text.compare(i, 2, "//") == 0) {
+            result.append(text.substr(i));
+            break;
+        }
+        if (text.compare(i, 2, "/*") == 0) {
+            result += "/*";
+            inComment = true;
+            i += 2;
+        } else if (c == '"') {
+            auto length = stringLength(text.substr(i));
+            if (length == std::string_view::npos) throw Unsupported();
+            result.append(text.substr(i, length));
+            i += length;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                   (c == '.' && i + 1 < text.size() &&
+                    std::isdigit(static_cast<unsigned char>(text[i + 1])))) {
+            // A preprocessing number, which may contain letters that are not macro names.
+            size_t end = i + 1;
+            while (end < text.size() &&
+                   (isIdentifierChar(text[end]) || text[end] == '.' ||
+                    ((text[end] == '+' || text[end] == '-') &&
+                     std::strchr("eEpP", text[end - 1]) != nullptr))) {
+                ++end;
+            }
+            result.append(text.substr(i, end - i));
+            i = end;
+        } else if (auto length = identifierLength(text.substr(i))) {
+            std::string name(text.substr(i, length));
+            i += length;
+            if (isBuiltinMacro(name)) throw Unsupported();
+            auto macro = macros.find(name);
+            if (macro == macros.end() || disabled.count(name)) {
+                result += name;
+                continue;
+            }
+            disabled.insert(name);
+            bool bodyInComment = false;
+            auto expansion = expand(macro->second, bodyInComment, disabled);
+            disabled.erase(name);
+            if (expansion.empty()) continue;
+            // cpp never lets an expansion form a new token with the text around it.
+            if (!result.empty() && wouldPaste(result.back(), expansion.front())) result += ' ';
+            result += expansion;
+            if (i < text.size() && wouldPaste(expansion.back(), text[i])) result += ' ';
+        } else {
+            result += c;
+            ++i;
+        }
+    }
+    return result;
+}
+
+bool Preprocessor::evaluateCondition(std::string_view expression) const {
+    // Replace each `defined NAME` and `defined(NAME)` before expanding the other macros.
+    std::string replaced;
+    for (size_t i = 0; i < expression.size();) {
+        auto length = identifierLength(expression.substr(i));
+        if (length == 0) {
+            replaced += expression[i++];
+            continue;
+        }
+        if (std::isdigit(static_cast<unsigned char>(replaced.empty() ? ' ' : replaced.back()))) {
+            replaced.append(expression.substr(i, length));
+            i += length;
+            continue;
+        }
+        auto name = expression.substr(i, length);
+        i += length;
+        if (name != "defined") {
+            replaced.append(name);
+            continue;
+        }
+        auto skipSpaces = [&]() {
+            while (i < expression.size() && std::isspace(static_cast<unsigned char>(expression[i])))
+                ++i;
+        };
+        skipSpaces();
+        bool parenthesized = i < expression.size() && expression[i] == '(';
+        if (parenthesized) {
+            ++i;
+            skipSpaces();
+        }
+        auto operandLength = identifierLength(expression.substr(i));
+        if (operandLength == 0) throw Unsupported();
+        bool isDefined = macros.count(std::string(expression.substr(i, operandLength))) != 0;
+        i += operandLength;
+        if (parenthesized) {
+            skipSpaces();
+            if (i >= expression.size() || expression[i] != ')') throw Unsupported();
+            ++i;
+        }
+        replaced += isDefined ? " 1 " : " 0 ";
+    }
+    bool inComment = false;
+    std::set<std::string> disabled;
+    auto expanded = expand(replaced, inComment, disabled);
+    if (expanded.find("defined") != std::string::npos) throw Unsupported();
+    return ConditionEvaluator().evaluate(expanded);
+}
+
+void Preprocessor::handleDefine(std::string_view rest) {
+    auto length = identifierLength(rest);
+    if (length == 0) throw Unsupported();
+    // Function-like macros are not supported.
+    if (length < rest.size() && rest[length] == '(') throw Unsupported();
+    auto body = trim(rest.substr(length));
+    if (body.find("##") != std::string_view::npos) throw Unsupported();
+    macros[std::string(rest.substr(0, length))] = std::string(body);
+}
+
+std::string Preprocessor::resolveInclude(std::string_view rest, const std::string &from) const {
+    if (rest.empty() || (rest[0] != '"' && rest[0] != '<')) throw Unsupported();
+    bool quoted = rest[0] == '"';
+    auto end = rest.find(quoted ? '"' : '>', 1);
+    if (end == std::string_view::npos || !trim(rest.substr(end + 1)).empty()) throw Unsupported();
+    std::string name(rest.substr(1, end - 1));
+    if (name.empty()) throw Unsupported();
+
+    std::error_code error;
+    if (name[0] == '/') {
+        if (std::filesystem::is_regular_file(name, error)) return name;
+        throw Unsupported();
+    }
+    std::vector<std::string> candidates;
+    if (quoted) {
+        auto slash = from.rfind('/');
+        candidates.push_back(slash == std::string::npos ? name
+                                                        : from.substr(0, slash + 1) + name);
+    }
+    for (const auto &dir : includeDirs) candidates.push_back(dir + "/" + name);
+    for (const auto &candidate : candidates) {
+        if (std::filesystem::is_regular_file(candidate, error)) return candidate;
+    }
+    throw Unsupported();
+}
+
+void Preprocessor::processFile(const std::string &name, unsigned depth) {
+    if (name.find_first_of("\"\\\n") != std::string::npos) throw Unsupported();
+    std::ifstream in(name);
+    if (!in) throw Unsupported();
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        lines.push_back(std::move(line));
+    }
+
+    /// A conditional group: #if, #ifdef or #ifndef with its #elif and #else branches.
+    struct Group {
+        bool parentActive;
+        bool active;
+        bool taken;
+        bool seenElse;
+    };
+    std::vector<Group> groups;
+    auto isActive = [&groups]() { return groups.empty() || groups.back().active; };
+
+    bool inComment = false;
+    for (size_t index = 0; index < lines.size(); ++index) {
+        std::string_view line = lines[index];
+        auto directive = inComment ? std::nullopt : directiveText(line);
+        if (!directive) {
+            if (!isActive()) {
+                skipLine(line, inComment);
+            } else {
+                if (!line.empty() && line.back() == '\\') throw Unsupported();
+                std::set<std::string> disabled;
+                output += expand(line, inComment, disabled);
+            }
+            output += '\n';
+            continue;
+        }
+
+        // Join continuation lines and keep one blank output line for each input line.
+        std::string joined(*directive);
+        size_t lineCount = 1;
+        while (!joined.empty() && joined.back() == '\\' && index + 1 < lines.size()) {
+            joined.pop_back();
+            joined += lines[++index];
+            ++lineCount;
+        }
+        auto text = stripComments(joined);
+        auto body = trim(text);
+        auto keywordLength = identifierLength(body);
+        auto keyword = body.substr(0, keywordLength);
+        auto rest = trim(body.substr(keywordLength));
+
+        if (keyword == "if" || keyword == "ifdef" || keyword == "ifndef") {
+            bool parentActive = isActive();
+            bool condition = false;
+            if (keyword == "if") {
+                condition = parentActive && evaluateCondition(rest);
+            } else {
+                if (identifierLength(rest) != rest.size() || rest.empty()) throw Unsupported();
+                condition = parentActive && (macros.count(std::string(rest)) != 0) ==
+                                                (keyword == "ifdef");
+            }
+            groups.push_back({parentActive, condition, condition, false});
+        } else if (keyword == "elif") {
+            if (groups.empty() || groups.back().seenElse) throw Unsupported();
+            auto &group = groups.back();
+            group.active = group.parentActive && !group.taken && evaluateCondition(rest);
+            group.taken = group.taken || group.active;
+        } else if (keyword == "else") {
+            if (groups.empty() || groups.back().seenElse) throw Unsupported();
+            auto &group = groups.back();
+            group.active = group.parentActive && !group.taken;
+            group.taken = true;
+            group.seenElse = true;
+        } else if (keyword == "endif") {
+            if (groups.empty()) throw Unsupported();
+            groups.pop_back();
+        } else if (!isActive()) {
+            // cpp ignores all other directives in skipped groups.
+        } else if (body.empty()) {
+            // The null directive.
+        } else if (keyword == "define") {
+            handleDefine(rest);
+        } else if (keyword == "undef") {
+            if (identifierLength(rest) != rest.size() || rest.empty()) throw Unsupported();
+            macros.erase(std::string(rest));
+        } else if (keyword == "pragma" && rest == "once") {
+            onceFiles.insert(std::filesystem::weakly_canonical(name));
+        } else if (keyword == "include") {
+            auto included = resolveInclude(rest, name);
+            if (depth + 1 > maxIncludeDepth) throw Unsupported();
+            if (onceFiles.count(std::filesystem::weakly_canonical(included))) {
+                output.append(lineCount, '\n');
+                continue;
+            }
+            output += "# 1 \"" + included + "\" 1\n";
+            processFile(included, depth + 1);
+            output += "# " + std::to_string(index + 2) + " \"" + name + "\" 2\n";
+            continue;
+        } else {
+            // #error, #warning, #line, other pragmas and the GNU extensions.
+            throw Unsupported();
+        }
+        output.append(lineCount, '\n');
+    }
+    if (!groups.empty() || inComment) throw Unsupported();
+}
+
+std::optional<std::string> Preprocessor::process(const std::filesystem::path &file) {
+    // Definitions made by the file must not leak into the next call.
+    auto savedMacros = macros;
+    auto savedOnceFiles = onceFiles;
+    std::optional<std::string> result;
+    output.clear();
+    try {
+        auto name = file.string();
+        if (name.find_first_of("\"\\\n") != std::string::npos) throw Unsupported();
+        output += "# 1 \"" + name + "\"\n";
+        processFile(name, 0);
+        result = std::move(output);
+    } catch (const Unsupported &) {
+    } catch (const std::filesystem::filesystem_error &) {
+    }
+    output.clear();
+    macros = std::move(savedMacros);
+    onceFiles = std::move(savedOnceFiles);
+    return result;
+}
+
+}  // namespace P4
@@ -0,0 +1,78 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef FRONTENDS_COMMON_PREPROCESSOR_H_
+#define FRONTENDS_COMMON_PREPROCESSOR_H_
+
+#include <filesystem>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace P4 {
+
+/// An in-process replacement for the external C preprocessor, covering what P4 programs and
+/// the p4include headers use: #include, object-like #define and #undef, conditional groups
+/// with integer #if expressions, and #pragma once. The output is that of `cpp -C` up to
+/// whitespace, with the same line markers, so source positions do not change.
+///
+/// Anything else, such as function-like macros, #error, #line or __LINE__, makes process()
+/// fail without reporting an error. The caller then falls back to the external preprocessor,
+/// which also produces the diagnostics for malformed input.
+class Preprocessor {
+ public:
+    /// Adds a directory searched by #include, after the directories added before.
+    void addIncludeDir(std::filesystem::path dir);
+
+    /// Defines an object-like macro, as -D does. @p definition is either NAME or NAME=VALUE.
+    /// @returns false if the definition is not supported.
+    bool define(std::string_view definition);
+
+    /// Removes a macro definition, as -U does.
+    void undefine(std::string_view name);
+
+    /// Applies preprocessor command-line options. Only -I, -D and -U, each written as a single
+    /// argument, are supported. @returns false if any option is not supported.
+    bool addOptions(std::string_view options);
+
+    /// @returns the preprocessed contents of @p file, or std::nullopt if the file cannot be
+    /// read or uses anything this preprocessor does not support.
+    std::optional<std::string> process(const std::filesystem::path &file);
+
+ private:
+    /// Expands the macros in a line of text, which may start or end inside a block comment.
+    std::string expand(std::string_view text, bool &inComment,
+                       std::set<std::string> &disabled) const;
+    /// Evaluates the expression of an #if or #elif directive.
+    bool evaluateCondition(std::string_view expression) const;
+    /// Handles a #define directive; @p rest is the text after the directive name.
+    void handleDefine(std::string_view rest);
+    /// Finds the file named by an #include directive in @p from.
+    std::string resolveInclude(std::string_view rest, const std::string &from) const;
+    /// Appends the preprocessed contents of @p name, included @p depth levels deep.
+    void processFile(const std::string &name, unsigned depth);
+
+    std::vector<std::string> includeDirs;
+    std::unordered_map<std::string, std::string> macros;
+    /// Files that contain #pragma once.
+    std::set<std::filesystem::path> onceFiles;
+    std::string output;
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_PREPROCESSOR_H_ */
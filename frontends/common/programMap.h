@@ -56,6 +56,9 @@ class ProgramMap : public IHasDbPrint {
         program = node->to<IR::P4Program>();
         LOG2(mapKind << " updated to " << dbp(node));
     }
+    /// @returns the program this map was computed for, or nullptr if the map has been
+    /// cleared.
+    const IR::P4Program *getProgram() const { return program == fake ? nullptr : program; }
     void clear() {
         // This ensures that a clear map is never up-to-date,
         // since the 'fake' node cannot appear in a program.
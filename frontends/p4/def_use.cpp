@@ -292,38 +292,28 @@ bool ProgramPoint::operator==(const ProgramPoint &other) const {
 
 std::size_t ProgramPoint::hash() const { return Util::hash_range(stack.begin(), stack.end()); }
 
+unsigned ProgramPointTable::number(const ProgramPoint &point) {
+    auto [it, inserted] = numbers.emplace(point, points.size());
+    if (inserted) points.push_back(point);
+    return it->second;
+}
+
 void ProgramPoints::add(const ProgramPoints *from) {
-    points.insert(from->points.begin(), from->points.end());
+    if (from->table == nullptr) return;
+    if (table == nullptr) table = from->table;
+    BUG_CHECK(table == from->table, "program points numbered by different tables");
+    points |= from->points;
 }
 
 // Take the union of the current object with another.  A new ProgramPoints
 // will be allocated if necessary, but in the case where one of the two
 // ProgramPoints is a subset of the other, the latter will itself be returned.
 const ProgramPoints *ProgramPoints::merge(const ProgramPoints *with) const {
-    if (with == this) {
-        // Notice the case where the two are identical and exit early to avoid
-        // the iteration.
-        return this;
-    } else {
-        // Iterate over the (weakly) smaller of the two.
-        ProgramPoints *result = nullptr;
-        const ProgramPoints *larger = this, *smaller = with;
-        if (size() < with->size()) std::swap(larger, smaller);
-        for (auto pp : smaller->points) {
-            if (!larger->points.count(pp)) {
-                if (!result) result = new ProgramPoints(larger->points);
-                result->points.insert(pp);
-            }
-        }
-        return result ? result : larger;
-    }
-}
-
-bool ProgramPoints::operator==(const ProgramPoints &other) const {
-    if (points.size() != other.points.size()) return false;
-    for (auto p : points)
-        if (other.points.find(p) == other.points.end()) return false;
-    return true;
+    if (with == this || points.contains(with->points)) return this;
+    if (with->points.contains(points)) return with;
+    auto result = new ProgramPoints(*this);
+    result->add(with);
+    return result;
 }
 
 Definitions *Definitions::joinDefinitions(const Definitions *other) const {
@@ -377,9 +367,9 @@ const ProgramPoints *Definitions::getPoints(const LocationSet &locations) const
     return result;
 }
 
-Definitions *Definitions::writes(ProgramPoint point, const LocationSet &locations) const {
+Definitions *Definitions::writes(const ProgramPoints *points,
+                                 const LocationSet &locations) const {
     auto result = new Definitions(*this);
-    auto points = new ProgramPoints(point);
     for (auto l : locations.canonical()) result->setDefinition(l->to<BaseLocation>(), points);
     return result;
 }
@@ -408,8 +398,8 @@ void ComputeWriteSet::enterScope(const IR::ParameterList *parameters,
     if (!clear) defs = currentDefinitions;
     if (defs == nullptr) defs = new Definitions();
 
-    auto startPoints = new ProgramPoints(entryPoint);
-    auto uninit = new ProgramPoints(ProgramPoint::beforeStart);
+    auto startPoints = allDefinitions->getPoints(entryPoint);
+    auto uninit = allDefinitions->getPoints(ProgramPoint::beforeStart);
 
     if (parameters != nullptr) {
         for (auto p : parameters->parameters) {
@@ -883,7 +873,7 @@ bool ComputeWriteSet::preorder(const IR::IfStatement *statement) {
     visit(statement->condition);
     auto cond = getWrites(statement->condition);
     // defs are the definitions after evaluating the condition
-    auto defs = currentDefinitions->writes(getProgramPoint(), *cond);
+    auto defs = currentDefinitions->writes(getProgramPoints(), *cond);
     (void)setDefinitions(defs, statement->condition, false);
     visit(statement->ifTrue);
     auto result = currentDefinitions;
@@ -910,7 +900,7 @@ bool ComputeWriteSet::preorder(const IR::ForStatement *statement) {
         visit(statement->condition, "condition");
         auto cond = getWrites(statement->condition);
         // exitDefs are the definitions after evaluating the condition
-        exitDefs = currentDefinitions->writes(getProgramPoint(), *cond);
+        exitDefs = currentDefinitions->writes(getProgramPoints(), *cond);
         (void)setDefinitions(exitDefs, statement->condition, true);
         visit(statement->body, "body");
         currentDefinitions = currentDefinitions->joinDefinitions(continueDefinitions);
@@ -942,7 +932,7 @@ bool ComputeWriteSet::preorder(const IR::ForInStatement *statement) {
         visit(statement->ref, "ref");
         lhs = false;
         auto cond = getWrites(statement->ref);
-        auto defs = currentDefinitions->writes(getProgramPoint(), *cond);
+        auto defs = currentDefinitions->writes(getProgramPoints(), *cond);
         (void)setDefinitions(defs, statement->ref, true);
         visit(statement->body, "body");
         currentDefinitions = currentDefinitions->joinDefinitions(continueDefinitions);
@@ -1009,7 +999,7 @@ bool ComputeWriteSet::preorder(const IR::BaseAssignmentStatement *statement) {
     auto l = getWrites(statement->left);
     auto r = getWrites(statement->right);
     locs = l->join(r);
-    auto defs = currentDefinitions->writes(getProgramPoint(), *locs);
+    auto defs = currentDefinitions->writes(getProgramPoints(), *locs);
     return setDefinitions(defs);
 }
 
@@ -1018,7 +1008,7 @@ bool ComputeWriteSet::preorder(const IR::SwitchStatement *statement) {
     if (currentDefinitions->isUnreachable()) return setDefinitions(currentDefinitions);
     visit(statement->expression);
     auto locs = getWrites(statement->expression);
-    auto defs = currentDefinitions->writes(getProgramPoint(statement->expression), *locs);
+    auto defs = currentDefinitions->writes(getProgramPoints(statement->expression), *locs);
     (void)setDefinitions(defs, statement->expression, false);
     auto save = currentDefinitions;
     auto result = new Definitions();
@@ -1143,7 +1133,7 @@ bool ComputeWriteSet::preorder(const IR::MethodCallStatement *statement) {
     lhs = false;
     visit(statement->methodCall);
     auto locs = getWrites(statement->methodCall);
-    auto defs = currentDefinitions->writes(getProgramPoint(), *locs);
+    auto defs = currentDefinitions->writes(getProgramPoints(), *locs);
     return setDefinitions(defs, statement, true);  // overwrite
 }
 
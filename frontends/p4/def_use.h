@@ -17,12 +17,16 @@ limitations under the License.
 #ifndef FRONTENDS_P4_DEF_USE_H_
 #define FRONTENDS_P4_DEF_USE_H_
 
+#include <deque>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_set.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "ir/ir.h"
 #include "lib/alloc_trace.h"
+#include "lib/bitvec.h"
 #include "lib/flat_map.h"
 #include "lib/hash.h"
 #include "lib/hvec_map.h"
@@ -472,28 +476,67 @@ struct Hasher<P4::loc_t> {
 }  // namespace P4::Util
 
 namespace P4 {
+/// Numbers the program points met by one def-use analysis, so that sets of
+/// program points can be represented as bit vectors.
+class ProgramPointTable {
+    absl::flat_hash_map<ProgramPoint, unsigned, Util::Hash> numbers;
+    /// A deque so that references to points stay valid as the table grows.
+    std::deque<ProgramPoint> points;
+
+ public:
+    /// ProgramPoint::beforeStart always has this number.
+    static constexpr unsigned beforeStart = 0;
+
+    ProgramPointTable() { number(ProgramPoint::beforeStart); }
+    ProgramPointTable(const ProgramPointTable &) = delete;
+    ProgramPointTable &operator=(const ProgramPointTable &) = delete;
+    /// @returns the number of @p point, numbering it if it is new.
+    unsigned number(const ProgramPoint &point);
+    const ProgramPoint &at(unsigned number) const { return points.at(number); }
+    size_t size() const { return points.size(); }
+};
+
+/// A set of program points, stored as a bit vector indexed by the numbers
+/// of a ProgramPointTable.  Sets built from different tables must not be
+/// combined.
 class ProgramPoints : public IHasDbPrint {
-    typedef absl::flat_hash_set<ProgramPoint, Util::Hash> Points;
-    Points points;
-    explicit ProgramPoints(const Points &points) : points(points) {}
+    /// Table numbering the points; nullptr as long as the set is empty.
+    const ProgramPointTable *table = nullptr;
+    bitvec points;
 
  public:
+    class const_iterator {
+        const ProgramPointTable *table;
+        bitvec::const_bitref bit;
+
+     public:
+        const_iterator(const ProgramPointTable *table, bitvec::const_bitref bit)
+            : table(table), bit(bit) {}
+        const ProgramPoint &operator*() const { return table->at(*bit); }
+        const_iterator &operator++() {
+            ++bit;
+            return *this;
+        }
+        bool operator==(const const_iterator &other) const { return bit == other.bit; }
+        bool operator!=(const const_iterator &other) const { return bit != other.bit; }
+    };
+
     ProgramPoints() = default;
-    explicit ProgramPoints(ProgramPoint point) { points.emplace(point); }
+    ProgramPoints(ProgramPointTable *table, const ProgramPoint &point) : table(table) {
+        points.setbit(table->number(point));
+    }
     void add(const ProgramPoints *from);
     const ProgramPoints *merge(const ProgramPoints *with) const;
-    bool operator==(const ProgramPoints &other) const;
+    bool operator==(const ProgramPoints &other) const { return points == other.points; }
     void dbprint(std::ostream &out) const override {
         out << "{";
-        for (auto p : points) out << p << " ";
+        for (const auto &p : *this) out << p << " ";
         out << "}";
     }
-    size_t size() const { return points.size(); }
-    bool containsBeforeStart() const {
-        return points.find(ProgramPoint::beforeStart) != points.end();
-    }
-    Points::const_iterator begin() const { return points.cbegin(); }
-    Points::const_iterator end() const { return points.cend(); }
+    size_t size() const { return points.popcount(); }
+    bool containsBeforeStart() const { return points.getbit(ProgramPointTable::beforeStart); }
+    const_iterator begin() const { return const_iterator(table, points.begin()); }
+    const_iterator end() const { return const_iterator(table, points.end()); }
 };
 
 /// List of definers for each base storage (at a specific program point).
@@ -509,8 +552,8 @@ class Definitions : public IHasDbPrint {
     Definitions(const Definitions &other)
         : definitions(other.definitions), unreachable(other.unreachable) {}
     Definitions *joinDefinitions(const Definitions *other) const;
-    /// Point writes the specified LocationSet.
-    Definitions *writes(ProgramPoint point, const LocationSet &locations) const;
+    /// Points write the specified LocationSet.
+    Definitions *writes(const ProgramPoints *points, const LocationSet &locations) const;
     void setDefintion(const BaseLocation *loc, const ProgramPoints *point) {
         CHECK_NULL(loc);
         CHECK_NULL(point);
@@ -558,10 +601,17 @@ class AllDefinitions : public IHasDbPrint {
     /// ProgramPoint.
     hvec_map<ProgramPoint, Definitions *> atPoint;
     StorageMap storageMap;
+    /// Numbers all ProgramPoints stored in these definitions.
+    ProgramPointTable points;
 
  public:
     AllDefinitions(ReferenceMap *refMap, TypeMap *typeMap) : storageMap(refMap, typeMap) {}
 
+    /// @returns the set containing only @p point.
+    const ProgramPoints *getPoints(const ProgramPoint &point) {
+        return new ProgramPoints(&points, point);
+    }
+
     Definitions *getDefinitions(ProgramPoint point, bool emptyIfNotFound = false) {
         auto it = atPoint.find(point);
         if (it == atPoint.end()) {
@@ -726,6 +776,9 @@ class ComputeWriteSet : public Inspector, public IHasDbPrint {
     Definitions *getDefinitionsAfter(const IR::ParserState *state);
     bool setDefinitions(Definitions *defs, const IR::Node *who = nullptr, bool overwrite = false);
     ProgramPoint getProgramPoint(const IR::Node *node = nullptr) const;
+    const ProgramPoints *getProgramPoints(const IR::Node *node = nullptr) const {
+        return allDefinitions->getPoints(getProgramPoint(node));
+    }
     // Get writes of a node that is a direct child of the currently being visited node.
     const LocationSet *getWrites(const IR::Expression *expression) {
         const loc_t &exprLoc = *getLoc(expression, getChildContext());
@@ -31,6 +31,7 @@ class Reassociation final : public Transform {
  public:
     Reassociation() {
         visitDagOnce = true;
+        skipUnchangedSubtrees = true;
         setName("Reassociation");
     }
     using Transform::postorder;
@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "typeChecker.h"
 
+#include <set>
+
+#include "absl/container/flat_hash_set.h"
 #include "constantTypeSubstitution.h"
 #include "frontends/common/constantFolding.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
@@ -28,6 +31,98 @@ limitations under the License.
 
 namespace P4 {
 
+namespace {
+
+/// Collects the names of all paths in a node, i.e., every name the node may refer to.
+class CollectPathNames : public Inspector {
+    std::set<cstring> &names;
+
+ public:
+    explicit CollectPathNames(std::set<cstring> &names) : names(names) {
+        setName("CollectPathNames");
+    }
+    bool preorder(const IR::Path *path) override {
+        names.insert(path->name.name);
+        return false;
+    }
+};
+
+/// Removes all nodes in a subtree from a TypeMap.
+class ForgetTypes : public Inspector {
+    TypeMap *typeMap;
+
+ public:
+    explicit ForgetTypes(TypeMap *typeMap) : typeMap(typeMap) { setName("ForgetTypes"); }
+    bool preorder(const IR::Node *node) override {
+        typeMap->forget(node);
+        return true;
+    }
+};
+
+}  // namespace
+
+bool ClearTypeMap::forgetChanged(const IR::P4Program *program) {
+    const auto *previous = typeMap->getProgram();
+    if (previous == nullptr) return false;
+
+    // Names whose meaning may have changed: those of added, replaced and removed declarations.
+    absl::flat_hash_set<const IR::Node *, Util::Hash> previousObjects(previous->objects.begin(),
+                                                                      previous->objects.end());
+    absl::flat_hash_set<const IR::Node *, Util::Hash> currentObjects(program->objects.begin(),
+                                                                     program->objects.end());
+    std::set<cstring> changedNames;
+    auto addChanged = [&changedNames](const IR::Node *object) {
+        const auto *decl = object->to<IR::IDeclaration>();
+        // Unnamed declarations, e.g. match_kind, declare names of their own.
+        if (decl == nullptr) return false;
+        changedNames.insert(decl->getName().name);
+        return true;
+    };
+    std::vector<const IR::Node *> unchanged;
+    std::vector<const IR::Node *> changed;
+    for (const auto *object : program->objects) {
+        if (previousObjects.count(object)) {
+            unchanged.push_back(object);
+        } else {
+            if (!addChanged(object)) return false;
+            changed.push_back(object);
+        }
+    }
+    for (const auto *object : previous->objects) {
+        if (!currentObjects.count(object) && !addChanged(object)) return false;
+    }
+
+    // Declarations that refer to a changed name are changed as well, as is everything that
+    // refers to them in turn.
+    std::vector<std::set<cstring>> references(unchanged.size());
+    for (size_t i = 0; i < unchanged.size(); ++i) {
+        CollectPathNames collect(references[i]);
+        unchanged[i]->apply(collect);
+    }
+    std::vector<bool> affected(unchanged.size(), false);
+    for (bool grew = true; grew;) {
+        grew = false;
+        for (size_t i = 0; i < unchanged.size(); ++i) {
+            if (affected[i]) continue;
+            for (auto name : references[i]) {
+                if (!changedNames.count(name)) continue;
+                affected[i] = true;
+                changed.push_back(unchanged[i]);
+                grew |= addChanged(unchanged[i]);
+                break;
+            }
+        }
+    }
+    // Forgetting most of the program costs more than starting afresh.
+    if (changed.size() * 2 > program->objects.size()) return false;
+
+    LOG2("Re-inferring types of " << changed.size() << " of " << program->objects.size()
+                                  << " declarations");
+    ForgetTypes forget(typeMap);
+    for (const auto *object : changed) object->apply(forget);
+    return true;
+}
+
 #if DEBUG_TYPES
 TypeChecking::TypeChecking(ReferenceMap *refMap, TypeMap *typeMap, bool updateExpressions) {
     addPasses({new P4::TypeInference(typeMap, /* readOnly */ true, /* checkArrays */ true,
@@ -33,6 +33,13 @@ class ClearTypeMap : public Inspector {
     TypeMap *typeMap;
     bool force;
 
+    /// Forgets the types in the top-level declarations of @p program that are new since the
+    /// map was computed, and in those that refer by name, directly or indirectly, to a
+    /// declaration that was added, replaced or removed.  Types in all other declarations stay
+    /// valid, so type inference only has to re-infer what changed.
+    /// @returns false if the whole map has to be cleared instead.
+    bool forgetChanged(const IR::P4Program *program);
+
  public:
     explicit ClearTypeMap(TypeMap *typeMap, bool force = false) : typeMap(typeMap), force(force) {
         CHECK_NULL(typeMap);
@@ -43,7 +50,7 @@ class ClearTypeMap : public Inspector {
         // because the program is saved only *after* typechecking,
         // so if the program changes during type-checking, the
         // typeMap may not be complete.
-        if (force || !typeMap->checkMap(program)) typeMap->clear();
+        if (force || (!typeMap->checkMap(program) && !forgetChanged(program))) typeMap->clear();
         return false;  // prune()
     }
 };
@@ -67,6 +67,7 @@ class TypeSubstitution : public IHasDbPrint {
         }
     }
 
+    void erase(T t) { binding.erase(t); }
     void clear() { binding.clear(); }
 };
 
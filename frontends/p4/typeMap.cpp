@@ -90,6 +90,16 @@ void TypeMap::clear() {
     ProgramMap::clear();
 }
 
+void TypeMap::forget(const IR::Node *element) {
+    CHECK_NULL(element);
+    typeMap.erase(element);
+    if (const auto *expression = element->to<IR::Expression>()) {
+        leftValues.erase(expression);
+        constants.erase(expression);
+    }
+    if (const auto *var = element->to<IR::ITypeVar>()) allTypeVariables.erase(var);
+}
+
 void TypeMap::checkPrecondition(const IR::Node *element, const IR::Type *type) const {
     CHECK_NULL(element);
     CHECK_NULL(type);
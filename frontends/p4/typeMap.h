@@ -75,6 +75,9 @@ class TypeMap final : public ProgramMap {
     const IR::Type *getTypeType(const IR::Node *element, bool notNull) const;
     void dbprint(std::ostream &out) const override;
     void clear();
+    /// Removes everything known about @p element: its type, whether it is a left value or a
+    /// compile-time constant, and its substitution if it is a type variable.
+    void forget(const IR::Node *element);
     bool isLeftValue(const IR::Expression *expression) const {
         return leftValues.count(expression) > 0;
     }
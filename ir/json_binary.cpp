@@ -0,0 +1,152 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/json_binary.h"
+
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "ir/json_parser.h"
+#include "lib/exceptions.h"
+
+namespace P4::JsonBinary {
+
+Writer::Writer(std::ostream &out) : out(out) {
+    out.write(magic, sizeof(magic) - 1);
+    out.put(static_cast<char>(version));
+}
+
+void Writer::tag(Tag t) { out.put(static_cast<char>(t)); }
+
+void Writer::varint(uint64_t v) {
+    while (v >= 0x80) {
+        out.put(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.put(static_cast<char>(v));
+}
+
+void Writer::string(std::string_view s) {
+    auto [it, inserted] = strings.emplace(s, strings.size());
+    if (!inserted) {
+        varint(it->second + 1);
+        return;
+    }
+    varint(0);
+    varint(s.size());
+    out.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+void Writer::number(const big_int &v) {
+    static const big_int maxU64 = std::numeric_limits<uint64_t>::max();
+    if (v >= 0 && v <= maxU64) {
+        number(static_cast<uint64_t>(v));
+    } else if (v < 0 && -(v + 1) <= maxU64) {
+        tag(NegInt);
+        varint(static_cast<uint64_t>(-(v + 1)));
+    } else {
+        tag(BigInt);
+        string(v.str());
+    }
+}
+
+namespace {
+
+class Reader {
+    std::istream &in;
+    std::vector<cstring> strings;
+
+    uint8_t byte() {
+        int c = in.get();
+        BUG_CHECK(c != std::char_traits<char>::eof(), "truncated binary IR input");
+        return static_cast<uint8_t>(c);
+    }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            BUG_CHECK(shift < 64, "malformed varint in binary IR input");
+            uint8_t b = byte();
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+    }
+
+    cstring string() {
+        if (auto ref = varint()) {
+            BUG_CHECK(ref <= strings.size(), "invalid string reference in binary IR input");
+            return strings[ref - 1];
+        }
+        std::string s(varint(), '\0');
+        in.read(s.data(), static_cast<std::streamsize>(s.size()));
+        BUG_CHECK(in, "truncated binary IR input");
+        return strings.emplace_back(s);
+    }
+
+ public:
+    explicit Reader(std::istream &in) : in(in) {}
+
+    std::unique_ptr<JsonData> value() {
+        switch (auto t = byte()) {
+            case Null:
+                return std::make_unique<JsonNull>();
+            case False:
+                return std::make_unique<JsonBoolean>(false);
+            case True:
+                return std::make_unique<JsonBoolean>(true);
+            case PosInt:
+                return std::make_unique<JsonNumber>(big_int(varint()));
+            case NegInt:
+                return std::make_unique<JsonNumber>(-big_int(varint()) - 1);
+            case BigInt:
+                return std::make_unique<JsonNumber>(big_int(string().string()));
+            case String:
+                return std::make_unique<JsonString>(string().string_view());
+            case Vector: {
+                auto vec = std::make_unique<JsonVector>();
+                while (in.peek() != End) vec->push_back(value());
+                byte();
+                return vec;
+            }
+            case Object: {
+                auto obj = std::make_unique<JsonObject>();
+                for (uint8_t b; (b = byte()) != End;) {
+                    BUG_CHECK(b == Field, "expected field in binary IR input, got %1%", int(b));
+                    auto key = string();
+                    (*obj)[key] = value();
+                }
+                return obj;
+            }
+            default:
+                BUG("unexpected tag %1% in binary IR input", int(t));
+        }
+    }
+};
+
+}  // namespace
+
+std::unique_ptr<JsonData> read(std::istream &in) {
+    char header[sizeof(magic)];
+    in.read(header, sizeof(header));
+    BUG_CHECK(in && std::memcmp(header, magic, sizeof(magic) - 1) == 0,
+              "not a binary IR input");
+    BUG_CHECK(static_cast<uint8_t>(header[sizeof(magic) - 1]) == version,
+              "unsupported binary IR version %1%", int(header[sizeof(magic) - 1]));
+    return Reader(in).value();
+}
+
+}  // namespace P4::JsonBinary
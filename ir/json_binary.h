@@ -0,0 +1,99 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_JSON_BINARY_H_
+#define IR_JSON_BINARY_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "lib/big_int_util.h"
+
+/// @file
+/// A compact binary encoding of the JSON data model used to save and restore the IR.  It is
+/// produced by JSONGenerator with Encoding::Binary and accepted wherever JSON text is read
+/// (operator>>(std::istream &, std::unique_ptr<JsonData> &), and so JSONLoader).
+///
+/// The stream starts with a header (magic + version byte).  Each value then starts with a
+/// Tag byte.  Integers are LEB128 varints; strings, including object keys, are stored once in
+/// an implicit string table: a string is written as varint 0, its length and its bytes the
+/// first time it occurs, and as varint (index + 1) afterwards.  Vectors are a Vector tag, their
+/// elements and an End tag; objects are an Object tag, a sequence of (Field tag, key, value)
+/// and an End tag.  Sharing of IR nodes is expressed as in the text encoding, with Node_ID
+/// back-references.
+
+namespace P4 {
+
+class JsonData;
+
+namespace JsonBinary {
+
+/// The first byte (0x89) can never start a JSON text, which is how readers tell them apart.
+inline constexpr char magic[] = "\x89P4IR";
+inline constexpr uint8_t version = 1;
+
+enum Tag : uint8_t {
+    Null = 0,
+    False,
+    True,
+    PosInt,  // varint value
+    NegInt,  // varint (-value - 1)
+    BigInt,  // string with the decimal representation
+    String,  // string
+    Vector,  // values... End
+    Object,  // (Field key value)... End
+    Field,
+    End,
+};
+
+/// Low-level writer used by JSONGenerator.
+class Writer {
+    std::ostream &out;
+    std::unordered_map<std::string, uint64_t> strings;
+
+ public:
+    /// Writes the header.
+    explicit Writer(std::ostream &out);
+
+    void tag(Tag t);
+    void varint(uint64_t v);
+    void string(std::string_view s);
+    void number(int64_t v) {
+        if (v >= 0) {
+            tag(PosInt);
+            varint(static_cast<uint64_t>(v));
+        } else {
+            tag(NegInt);
+            varint(static_cast<uint64_t>(-(v + 1)));
+        }
+    }
+    void number(uint64_t v) {
+        tag(PosInt);
+        varint(v);
+    }
+    void number(const big_int &v);
+};
+
+/// Reads a binary-encoded value, header included, from @p in.
+std::unique_ptr<JsonData> read(std::istream &in);
+
+}  // namespace JsonBinary
+
+}  // namespace P4
+
+#endif /* IR_JSON_BINARY_H_ */
@@ -18,11 +18,13 @@ limitations under the License.
 #define IR_JSON_GENERATOR_H_
 
 #include <optional>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <unordered_set>
 #include <variant>
 
+#include "ir/json_binary.h"
 #include "ir/node.h"
 #include "lib/bitvec.h"
 #include "lib/cstring.h"
@@ -37,9 +39,16 @@ limitations under the License.
 namespace P4 {
 
 class JSONGenerator {
+ public:
+    /// Text is regular JSON; Binary is the compact encoding described in ir/json_binary.h.
+    /// Both are read back by JSONLoader.
+    enum class Encoding { Text, Binary };
+
+ private:
     std::unordered_set<int> node_refs;
     std::ostream &out;
     bool dumpSourceInfo;
+    std::optional<JsonBinary::Writer> binary;
 
     template <typename T>
     class has_toJSON {
@@ -90,15 +99,21 @@ class JSONGenerator {
     };
 
  public:
-    explicit JSONGenerator(std::ostream &out, bool dumpSourceInfo = false)
-        : out(out), dumpSourceInfo(dumpSourceInfo) {}
+    explicit JSONGenerator(std::ostream &out, bool dumpSourceInfo = false,
+                           Encoding encoding = Encoding::Text)
+        : out(out), dumpSourceInfo(dumpSourceInfo) {
+        if (encoding == Encoding::Binary) binary.emplace(out);
+    }
 
     state_restore_t begin_vector() {
         if (output_state == OBJ_START) output_state = OBJ_END;
         BUG_CHECK(output_state != VEC_START, "invalid json output state in begin_vector");
         state_restore_t rv(*this, VECTOR);
         output_state = VEC_START;
-        out << '[';
+        if (binary)
+            binary->tag(JsonBinary::Vector);
+        else
+            out << '[';
         ++indent;
         return rv;
     }
@@ -107,11 +122,15 @@ class JSONGenerator {
         BUG_CHECK(prev.kind == VECTOR, "invalid previous state in end_vector");
         prev.kind = NONE;
         --indent;
-        if (output_state == VEC_MID)
-            out << std::endl << indent;
-        else if (output_state != VEC_START)
+        if (output_state == VEC_MID) {
+            if (!binary) out << std::endl << indent;
+        } else if (output_state != VEC_START) {
             BUG("invalid json output state in end_vector");
-        out << ']';
+        }
+        if (binary)
+            binary->tag(JsonBinary::End);
+        else
+            out << ']';
         if ((output_state = prev.prev_state) == OBJ_AFTERTAG) output_state = OBJ_MID;
     }
 
@@ -128,10 +147,19 @@ class JSONGenerator {
         prev.kind = NONE;
         switch (output_state) {
             case OBJ_START:
-                out << "{}";
+                if (binary) {
+                    binary->tag(JsonBinary::Object);
+                    binary->tag(JsonBinary::End);
+                } else {
+                    out << "{}";
+                }
                 break;
             case OBJ_MID:
-                out << std::endl << --indent << '}';
+                --indent;
+                if (binary)
+                    binary->tag(JsonBinary::End);
+                else
+                    out << std::endl << indent << '}';
                 break;
             case OBJ_END:
                 break;
@@ -149,10 +177,10 @@ class JSONGenerator {
     void emit(const T &val) {
         switch (output_state) {
             case VEC_MID:
-                out << ',';
+                if (!binary) out << ',';
                 /* fall through */
             case VEC_START:
-                out << std::endl << indent;
+                if (!binary) out << std::endl << indent;
                 output_state = VEC_MID;
                 break;
             case OBJ_AFTERTAG:
@@ -168,16 +196,20 @@ class JSONGenerator {
                 BUG("invalid json output state for emit(obj)");
         }
         generate(val);
-        if (output_state == TOP) out << std::endl;
+        if (output_state == TOP && !binary) out << std::endl;
     }
 
     void emit_tag(std::string_view tag) {
         switch (output_state) {
             case OBJ_START:
-                out << '{' << std::endl << ++indent;
+                ++indent;
+                if (binary)
+                    binary->tag(JsonBinary::Object);
+                else
+                    out << '{' << std::endl << indent;
                 break;
             case OBJ_MID:
-                out << ',' << std::endl << indent;
+                if (!binary) out << ',' << std::endl << indent;
                 break;
             case TOP:
             case VEC_START:
@@ -186,7 +218,12 @@ class JSONGenerator {
             case OBJ_END:
                 BUG("invalid json output state for emit_tag");
         }
-        out << '\"' << cstring(tag).escapeJson() << "\" : ";
+        if (binary) {
+            binary->tag(JsonBinary::Field);
+            binary->string(tag);
+        } else {
+            out << '\"' << cstring(tag).escapeJson() << "\" : ";
+        }
         output_state = OBJ_AFTERTAG;
     }
 
@@ -278,30 +315,73 @@ class JSONGenerator {
         end_object(t);
     }
 
-    void generate(bool v) { out << (v ? "true" : "false"); }
+    void generate_null() {
+        if (binary)
+            binary->tag(JsonBinary::Null);
+        else
+            out << "null";
+    }
+
+    /// Values that are written as the string produced by their operator<<.
+    template <typename T>
+    void generate_printed(const T &v) {
+        if (binary) {
+            std::stringstream tmp;
+            tmp << v;
+            binary->tag(JsonBinary::String);
+            binary->string(tmp.str());
+        } else {
+            out << "\"" << v << "\"";
+        }
+    }
+
+    void generate(bool v) {
+        if (binary)
+            binary->tag(v ? JsonBinary::True : JsonBinary::False);
+        else
+            out << (v ? "true" : "false");
+    }
     template <typename T>
     std::enable_if_t<std::is_integral_v<T>> generate(T v) {
-        out << std::to_string(v);
+        if (!binary)
+            out << std::to_string(v);
+        else if constexpr (std::is_signed_v<T>)
+            binary->number(static_cast<int64_t>(v));
+        else
+            binary->number(static_cast<uint64_t>(v));
+    }
+    // JSONLoader only reads back the integral part of a double, so that is all we store in
+    // the binary encoding.
+    void generate(double v) {
+        if (binary)
+            binary->number(static_cast<int64_t>(v));
+        else
+            out << std::to_string(v);
     }
-    void generate(double v) { out << std::to_string(v); }
     template <typename T>
     std::enable_if_t<std::is_same_v<T, big_int>> generate(const T &v) {
-        out << v;
+        if (binary)
+            binary->number(v);
+        else
+            out << v;
     }
 
     void generate(cstring v) {
-        if (v) {
-            out << "\"" << v.escapeJson() << "\"";
+        if (!v) {
+            generate_null();
+        } else if (binary) {
+            binary->tag(JsonBinary::String);
+            binary->string(v.string_view());
         } else {
-            out << "null";
+            out << "\"" << v.escapeJson() << "\"";
         }
     }
     template <typename T>
     std::enable_if_t<std::is_same_v<T, LTBitMatrix> || std::is_enum_v<T>> generate(T v) {
-        out << "\"" << v << "\"";
+        generate_printed(v);
     }
 
-    void generate(const bitvec &v) { out << "\"" << v << "\""; }
+    void generate(const bitvec &v) { generate_printed(v); }
 
     void generate(const match_t &v) {
         auto t = begin_object();
@@ -337,7 +417,7 @@ class JSONGenerator {
         if (v)
             generate(*v);
         else
-            out << "null";
+            generate_null();
     }
 
     template <typename T, size_t N>
@@ -22,6 +22,7 @@ limitations under the License.
 #include <utility>
 
 #include "absl/strings/escaping.h"
+#include "ir/json_binary.h"
 
 namespace P4 {
 
@@ -163,6 +164,10 @@ std::istream &operator>>(std::istream &in, std::unique_ptr<JsonData> &json) {
                 in.ignore(3);
                 json = std::make_unique<JsonNull>();
                 return in;
+            case JsonBinary::magic[0]:
+                in.unget();
+                json = JsonBinary::read(in);
+                return in;
             default:
                 return in;
         }
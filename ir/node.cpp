@@ -47,7 +47,7 @@ void IR::Node::traceCreation() const {
     LOG5("Created node " << id);
 }
 
-int IR::Node::currentId = 0;
+decltype(IR::Node::currentId) IR::Node::currentId{0};
 
 void IR::Node::toJSON(JSONGenerator &json) const {
     json.emit("Node_ID", id);
@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef IR_NODE_H_
 #define IR_NODE_H_
 
+#include <atomic>
 #include <iosfwd>
 
 #include "ir-tree-macros.h"
@@ -109,7 +110,12 @@ class Node : public virtual INode {
     Node &operator=(Node &&) = default;
 
  protected:
+#ifdef MULTITHREAD
+    // Nodes may be created concurrently, e.g. by the p4testgen parallel executor.
+    static std::atomic<int> currentId;
+#else
     static int currentId;
+#endif
     void traceVisit(const char *visitor) const;
     friend class ::P4::Visitor;
     friend class ::P4::Inspector;
@@ -123,6 +129,7 @@ class Node : public virtual INode {
     int id;        // unique id for each node
     int clone_id;  // unique id this node was cloned from (recursively)
     void traceCreation() const;
+    static int createdNodes() { return currentId; }  // number of nodes created so far
     Node() : id(currentId++), clone_id(id) { traceCreation(); }
     explicit Node(Util::SourceInfo si) : srcInfo(si), id(currentId++), clone_id(id) {
         traceCreation();
@@ -0,0 +1,172 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/pass_profile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <utility>
+
+#include "absl/strings/str_format.h"
+#include "ir/node.h"
+#include "lib/error.h"
+#include "lib/gc.h"
+
+namespace P4 {
+
+namespace {
+
+void writeJsonString(std::ostream &out, const std::string &str) {
+    out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+}  // namespace
+
+PassProfiler *PassProfiler::active = nullptr;
+
+PassProfiler::Sample PassProfiler::Sample::operator-(const Sample &other) const {
+    return {wallUs - other.wallUs, cpuUs - other.cpuUs, bytes - other.bytes, nodes - other.nodes};
+}
+
+PassProfiler::Sample &PassProfiler::Sample::operator+=(const Sample &other) {
+    wallUs += other.wallUs;
+    cpuUs += other.cpuUs;
+    bytes += other.bytes;
+    nodes += other.nodes;
+    return *this;
+}
+
+PassProfiler::PassProfiler(std::filesystem::path file)
+    : file(std::move(file)), thread(std::this_thread::get_id()), origin(Clock::now()) {}
+
+void PassProfiler::enable(std::filesystem::path file) {
+    if (active) {
+        active->file = std::move(file);
+        return;
+    }
+    active = new PassProfiler(std::move(file));
+    count_allocations(true);
+    static bool reportRegistered = false;
+    if (!reportRegistered) {
+        std::atexit(report);
+        reportRegistered = true;
+    }
+}
+
+void PassProfiler::disable() {
+    if (!active) return;
+    count_allocations(false);
+    delete active;
+    active = nullptr;
+}
+
+PassProfiler::Sample PassProfiler::now() const {
+    Sample sample;
+    sample.wallUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - origin).count();
+    sample.cpuUs = static_cast<int64_t>(std::clock()) * 1000000 / CLOCKS_PER_SEC;
+    sample.bytes = allocated_bytes();
+    sample.nodes = IR::Node::createdNodes();
+    return sample;
+}
+
+void PassProfiler::begin(const char *name) { stack.push_back({name, now(), {}}); }
+
+void PassProfiler::end() {
+    BUG_CHECK(!stack.empty(), "PassProfiler: no pass is running");
+    auto frame = std::move(stack.back());
+    stack.pop_back();
+    auto total = now() - frame.start;
+    if (!stack.empty()) stack.back().children += total;
+    events.push_back({std::move(frame.name), static_cast<unsigned>(stack.size()),
+                      frame.start.wallUs, total, total - frame.children});
+}
+
+PassProfiler::Scope::Scope(const char *name) : profiler(PassProfiler::get()) {
+    if (profiler && std::this_thread::get_id() != profiler->thread) profiler = nullptr;
+    if (profiler) profiler->begin(name);
+}
+
+PassProfiler::Scope::~Scope() {
+    if (profiler) profiler->end();
+}
+
+void PassProfiler::writeTrace(std::ostream &out) const {
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char *sep = "\n";
+    for (const auto &event : events) {
+        out << sep << "{\"name\":";
+        writeJsonString(out, event.name);
+        out << ",\"cat\":\"pass\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+            << ",\"ts\":" << event.startUs << ",\"dur\":" << event.total.wallUs
+            << ",\"args\":{\"depth\":" << event.depth << ",\"cpu_us\":" << event.total.cpuUs
+            << ",\"alloc_bytes\":" << event.total.bytes << ",\"nodes\":" << event.total.nodes
+            << ",\"self_wall_us\":" << event.self.wallUs << ",\"self_cpu_us\":" << event.self.cpuUs
+            << ",\"self_alloc_bytes\":" << event.self.bytes
+            << ",\"self_nodes\":" << event.self.nodes << "}}";
+        sep = ",\n";
+    }
+    out << "\n]}\n";
+}
+
+void PassProfiler::writeSummary(std::ostream &out, size_t top) const {
+    struct Totals {
+        size_t runs = 0;
+        Sample self;
+    };
+    std::map<std::string, Totals> byName;
+    for (const auto &event : events) {
+        auto &totals = byName[event.name];
+        ++totals.runs;
+        totals.self += event.self;
+    }
+    std::vector<std::pair<std::string, Totals>> sorted(byName.begin(), byName.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        return a.second.self.wallUs > b.second.self.wallUs;
+    });
+    if (sorted.size() > top) sorted.resize(top);
+
+    out << absl::StrFormat("%-48s %8s %12s %12s %14s %12s\n", "pass", "runs", "wall ms", "cpu ms",
+                           "alloc bytes", "nodes");
+    for (const auto &[name, totals] : sorted) {
+        out << absl::StrFormat("%-48s %8d %12.1f %12.1f %14d %12d\n", name, totals.runs,
+                               totals.self.wallUs / 1000.0, totals.self.cpuUs / 1000.0,
+                               totals.self.bytes, totals.self.nodes);
+    }
+}
+
+void PassProfiler::report() {
+    auto *profiler = active;
+    if (!profiler) return;
+    count_allocations(false);
+    std::ofstream out(profiler->file);
+    if (!out) {
+        std::cerr << "Cannot write pass profile " << profiler->file << std::endl;
+    } else {
+        profiler->writeTrace(out);
+    }
+    std::cerr << "Pass profile (self time and allocations, excluding nested passes):\n";
+    profiler->writeSummary(std::cerr, 30);
+}
+
+}  // namespace P4
@@ -0,0 +1,119 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_PASS_PROFILE_H_
+#define IR_PASS_PROFILE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace P4 {
+
+/// Records, for every pass run by a PassManager, its wall time, CPU time, the number of bytes
+/// allocated and the number of IR nodes created. Nested passes are recorded separately; the
+/// summary charges each pass only for the time and memory not spent in nested passes.
+///
+/// Allocations are counted by the allocator of the garbage collector, without taking stack traces
+/// or collecting the heap; without libgc, allocated bytes are reported as zero.
+/// Only passes run on the thread that enabled profiling are recorded.
+class PassProfiler {
+ public:
+    /// Starts profiling. When the process exits, a Chrome trace-event file is written to
+    /// @p file and a summary of the most expensive passes is printed to stderr.
+    static void enable(std::filesystem::path file);
+
+    /// Stops profiling and discards what was recorded, without writing a report.
+    static void disable();
+
+    /// @returns the active profiler, or nullptr if profiling is disabled.
+    static PassProfiler *get() { return active; }
+
+    /// Measures one pass from construction to destruction. Does nothing if profiling is
+    /// disabled.
+    class Scope {
+        PassProfiler *profiler;
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+     public:
+        explicit Scope(const char *name);
+        ~Scope();
+    };
+
+    /// Writes the recorded passes in Chrome trace-event format.
+    void writeTrace(std::ostream &out) const;
+
+    /// Writes the @p top passes with the highest self wall time, aggregated by pass name.
+    void writeSummary(std::ostream &out, size_t top) const;
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    /// Resource counters at one point in time.
+    struct Sample {
+        int64_t wallUs = 0;
+        int64_t cpuUs = 0;
+        uint64_t bytes = 0;
+        int64_t nodes = 0;
+
+        Sample operator-(const Sample &other) const;
+        Sample &operator+=(const Sample &other);
+    };
+
+    /// A pass that is currently running.
+    struct Frame {
+        std::string name;
+        Sample start;
+        /// Resources used by the passes nested in this one.
+        Sample children;
+    };
+
+    /// A pass that has finished.
+    struct Event {
+        std::string name;
+        unsigned depth;
+        int64_t startUs;
+        /// Resources used by the pass, including nested passes.
+        Sample total;
+        /// Resources used by the pass itself.
+        Sample self;
+    };
+
+    explicit PassProfiler(std::filesystem::path file);
+
+    Sample now() const;
+    void begin(const char *name);
+    void end();
+
+    /// Writes the report; registered with atexit.
+    static void report();
+
+    static PassProfiler *active;
+
+    std::filesystem::path file;
+    std::thread::id thread;
+    Clock::time_point origin;
+    std::vector<Frame> stack;
+    std::vector<Event> events;
+};
+
+}  // namespace P4
+
+#endif /* IR_PASS_PROFILE_H_ */
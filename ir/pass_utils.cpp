@@ -18,8 +18,18 @@ limitations under the License.
 
 #include <initializer_list>
 #include <tuple>
+#include <vector>
+#ifdef MULTITHREAD
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif
 
 #include "absl/strings/str_cat.h"
+#include "ir/ir.h"
+#include "lib/gc.h"
 #include "lib/log.h"
 #include "pass_utils.h"
 
@@ -103,4 +113,70 @@ DiagnosticCountInfoGuard DiagnosticCountInfo::getInfoGuard(std::string_view comp
     return {componentInfo, state};
 }
 
+void forEachIndex(size_t count, unsigned threads, const std::function<void(size_t)> &fn) {
+#ifdef MULTITHREAD
+    unsigned workers = threads ? threads : std::max(std::thread::hardware_concurrency(), 1U);
+    workers = std::min<size_t>(workers, count);
+    if (workers > 1) {
+        std::atomic<size_t> next{0};
+        std::exception_ptr failure;
+        std::mutex failure_mutex;
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < workers; ++t) {
+            pool.emplace_back([&] {
+                GCThreadRegistration gc_registration;
+                ThreadLocalAllocCache alloc_cache;
+                try {
+                    for (size_t i; (i = next++) < count;) fn(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> guard(failure_mutex);
+                    if (!failure) failure = std::current_exception();
+                    next = count;
+                }
+            });
+        }
+        for (auto &t : pool) t.join();
+        if (failure) std::rethrow_exception(failure);
+        return;
+    }
+#else
+    (void)threads;
+#endif
+    for (size_t i = 0; i < count; ++i) fn(i);
+}
+
+bool ParallelForEachDeclaration::isParserOrControl(const IR::Node *node) {
+    return node->is<IR::P4Parser>() || node->is<IR::P4Control>();
+}
+
+const IR::Node *ParallelForEachDeclaration::apply_visitor(const IR::Node *root, const char *) {
+    const auto *program = root->to<IR::P4Program>();
+    BUG_CHECK(program, "%1%: %2% must be applied to a P4Program", root, name());
+
+    std::vector<size_t> work;
+    for (size_t i = 0; i < program->objects.size(); ++i)
+        if (filter(program->objects[i])) work.push_back(i);
+    LOG2(name() << ": visiting " << work.size() << " declarations");
+
+    std::vector<const IR::Node *> results(program->objects.begin(), program->objects.end());
+    // TODO: passes keep static state that is not thread-safe, and compile contexts are pushed
+    // on a process-wide stack.  Until they are, the declarations are visited serially.
+    (void)threads;
+    forEachIndex(work.size(), 1, [&](size_t w) {
+        size_t i = work[w];
+        results[i] = program->objects[i]->apply(*makeVisitor());
+    });
+
+    bool changed = false;
+    IR::Vector<IR::Node> objects;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i] != program->objects[i]) changed = true;
+        if (results[i]) objects.pushBackOrAppend(results[i]);
+    }
+    if (!changed) return program;
+    auto *rv = program->clone();
+    rv->objects = std::move(objects);
+    return rv;
+}
+
 }  // namespace P4
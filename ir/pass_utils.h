@@ -17,6 +17,9 @@ limitations under the License.
 #ifndef IR_PASS_UTILS_H_
 #define IR_PASS_UTILS_H_
 
+#include <functional>
+#include <utility>
+
 #include "ir/pass_manager.h"
 #include "lib/compile_context.h"
 
@@ -95,6 +98,48 @@ struct DiagnosticCountInfo {
     std::shared_ptr<DiagnosticCountInfoState> state;
 };
 
+/// Calls @p fn(0) ... @p fn(count - 1), on up to @p threads worker threads (0 = one per hardware
+/// thread) in MULTITHREAD builds, serially otherwise.  The workers are registered with the
+/// garbage collector.  The first exception thrown by a worker is rethrown on the calling thread
+/// once all the workers are done.
+void forEachIndex(size_t count, unsigned threads, const std::function<void(size_t)> &fn);
+
+/// Applies a visitor independently to each top-level declaration of an IR::P4Program that
+/// matches a filter (by default parsers and controls) and splices the results back into
+/// IR::P4Program::objects in their original order.  Every declaration is visited by a fresh
+/// visitor obtained from @p makeVisitor (e.g. `[&] { return pass.clone(); }`).  The declarations
+/// are meant to be distributed over a pool of worker threads in MULTITHREAD builds; for now, they
+/// are visited one after another (see apply_visitor), with the same result.
+///
+/// The visitor must only depend on the declaration it is applied to: it must not read or update
+/// state shared between declarations (e.g. a ReferenceMap or TypeMap being filled), and as it is
+/// applied with the declaration as root, its context does not include the program.  A Transform
+/// may replace or remove a declaration, or expand it into a Vector of nodes.
+class ParallelForEachDeclaration : public Visitor {
+ public:
+    using VisitorFactory = std::function<Visitor *()>;
+    using Filter = std::function<bool(const IR::Node *)>;
+
+    /// @param threads  Number of worker threads once declarations are visited concurrently;
+    ///                 0 means one per hardware thread.
+    explicit ParallelForEachDeclaration(VisitorFactory makeVisitor, unsigned threads = 0,
+                                        Filter filter = isParserOrControl)
+        : makeVisitor(std::move(makeVisitor)), threads(threads), filter(std::move(filter)) {
+        setName("ParallelForEachDeclaration");
+    }
+    const IR::Node *apply_visitor(const IR::Node *root, const char *name = 0) override;
+    ParallelForEachDeclaration *clone() const override {
+        return new ParallelForEachDeclaration(*this);
+    }
+
+    static bool isParserOrControl(const IR::Node *node);
+
+ private:
+    VisitorFactory makeVisitor;
+    unsigned threads;
+    Filter filter;
+};
+
 }  // namespace P4
 
 #endif  // IR_PASS_UTILS_H_
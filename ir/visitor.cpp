@@ -21,6 +21,7 @@ limitations under the License.
 #include <time.h>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "ir/ir-generated.h"
@@ -62,15 +63,18 @@ class Visitor::ChangeTracker {
         // `result` saving 8 bytes per record
         bool visit_in_progress;
         bool visitOnce;
+        bool started;  // entry was made by try_start rather than as the result of another node
         const IR::Node *result;
     };
     using visited_t = absl::flat_hash_map<const IR::Node *, visit_info_t, Util::Hash>;
     bool forceClone;
+    int generation;  // first node id created during this traversal
     visited_t visited;
 
  public:
     explicit ChangeTracker(bool forceClone)
         : forceClone(forceClone),
+          generation(IR::Node::createdNodes()),
           visited(16) {}  // Pre-allocate 16 slots as usually these maps are small, but we do create
                           // lots of them. This saves quite some time for rehashes
 
@@ -84,7 +88,7 @@ class Visitor::ChangeTracker {
      */
     [[nodiscard]] VisitStatus try_start(const IR::Node *n, bool defaultVisitOnce) {
         // Initialization
-        auto [it, inserted] = visited.emplace(n, visit_info_t{true, defaultVisitOnce, n});
+        auto [it, inserted] = visited.emplace(n, visit_info_t{true, defaultVisitOnce, true, n});
 
         if (!inserted) {  // We already seen this node, determine its status
             if (it->second.visit_in_progress) return VisitStatus::Busy;
@@ -120,7 +124,7 @@ class Visitor::ChangeTracker {
             return true;
         } else if (forceClone || (final != orig && *final != *orig)) {
             orig_visit_info->result = final;
-            visited.emplace(final, visit_info_t{false, orig_visit_info->visitOnce, final});
+            visited.emplace(final, visit_info_t{false, orig_visit_info->visitOnce, false, final});
             return true;
         } else if (visited.count(final)) {
             // coalescing with some previously visited node, so we don't want to undo
@@ -211,6 +215,31 @@ class Visitor::ChangeTracker {
         if (it == visited.end()) BUG("visitor state tracker corrupted");
         it->second.visitOnce = false;
     }
+
+    /** Id of the first node created during this traversal.  Nodes are never modified once
+     * visited, so any node with a lower id existed unchanged before the traversal started. */
+    [[nodiscard]] int startGeneration() const { return generation; }
+
+    /** Add to @out every node that was visited and left unchanged, which makes it the root
+     * of an unchanged subtree.  Nodes created during the traversal are not included, as
+     * they have not been visited as input. */
+    void unchanged(absl::flat_hash_set<const IR::Node *, Util::Hash> &out) const {
+        for (const auto &[node, info] : visited) {
+            if (info.started && !info.visit_in_progress && info.result == node &&
+                node->id < generation)
+                out.insert(node);
+        }
+    }
+};
+
+/** Nodes that the last application of a Transform left unchanged.  See
+ * Transform::skipUnchangedSubtrees. */
+struct Transform::UnchangedSubtrees {
+    static constexpr size_t maxRetained = 1 << 20;
+    int generation;  // all nodes have lower ids
+    absl::flat_hash_set<const IR::Node *, Util::Hash> nodes;
+
+    bool contains(const IR::Node *n) const { return n->id < generation && nodes.count(n); }
 };
 
 /** @class Visitor::Tracker
@@ -378,8 +407,9 @@ Visitor::profile_t Transform::init_apply(const IR::Node *root) {
 void Visitor::end_apply() {}
 void Visitor::end_apply(const IR::Node *) {}
 
-static indent_t profile_indent;
-static absl::Time first_start = absl::InfinitePast();
+// Per thread, as visitors may run on several threads at once.
+static thread_local indent_t profile_indent;
+static thread_local absl::Time first_start = absl::InfinitePast();
 
 Visitor::profile_t::profile_t(Visitor &v_) : v(v_) {
     start = absl::Now();
@@ -550,6 +580,12 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
                 n = visited->result(n);
                 break;
             default: {  // New or Revisit
+                if (unchanged && unchanged->contains(n)) {
+                    // The previous application left this subtree unchanged, and this pass
+                    // does not depend on anything outside of it.
+                    visited->finish(n, n);
+                    break;
+                }
                 auto *copy = n->clone();
                 local.current.node = copy;
                 if (!dontForwardChildrenBeforePreorder) {
@@ -595,10 +631,20 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
             }
         }
     }
-    if (ctxt)
+    if (ctxt) {
         ctxt->child_index++;
-    else
+    } else {
+        if (skipUnchangedSubtrees && !forceClone) {
+            auto *rv = new UnchangedSubtrees{visited->startGeneration(), {}};
+            visited->unchanged(rv->nodes);
+            // Subtrees that were skipped this time were not traversed, so keep what is known
+            // about their descendants, unless that keeps too many stale nodes alive.
+            if (unchanged && unchanged->nodes.size() < UnchangedSubtrees::maxRetained)
+                rv->nodes.insert(unchanged->nodes.begin(), unchanged->nodes.end());
+            unchanged.reset(rv);
+        }
         visited.reset();
+    }
     return n;
 }
 
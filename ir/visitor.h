@@ -435,7 +435,9 @@ class Inspector : public virtual Visitor {
 };
 
 class Transform : public virtual Visitor {
+    struct UnchangedSubtrees;
     std::shared_ptr<ChangeTracker> visited;
+    std::shared_ptr<const UnchangedSubtrees> unchanged;
     bool prune_flag = false;
     void visitor_const_error() override;
     bool check_clone(const Visitor *) override;
@@ -468,6 +470,11 @@ class Transform : public virtual Visitor {
         return rv;
     }
     bool forceClone = false;  // force clone whole tree even if unchanged
+    // Set by passes whose result for a subtree depends on nothing but that subtree -- not on
+    // its context, nor on state outside the IR.  Subtrees that the previous application of
+    // the pass left unchanged are then not visited again, so re-running such a pass in a
+    // PassRepeated loop only visits what other passes have changed since.
+    bool skipUnchangedSubtrees = false;
 };
 
 // turn this on for extra info tracking control joinFlows for debugging
@@ -28,12 +28,15 @@ limitations under the License.
 #endif /* HAVE_LIBGC */
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
 #include <cstddef>
 #include <cstring>
 #include <functional>
 #include <iomanip>
 #include <ios>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -169,31 +172,63 @@ struct TableEntryHash {
     }
 };
 
-auto &cache() {
+// The table is split into shards, each with its own lock, so that threads interning
+// different strings rarely contend.  The shard is picked from the top bits of the hash; the
+// hash table inside the shard uses the low bits.
+constexpr unsigned cache_shard_bits = 6;
+constexpr std::size_t cache_shards = std::size_t(1) << cache_shard_bits;
+
+struct alignas(64) cache_shard {
+    std::mutex lock;
     // We need node_hash_set due to SSO: we return address of embedded string
     // that should be stable
-    static absl::node_hash_set<table_entry, TableEntryHash, std::equal_to<>> g_cache;
+    absl::node_hash_set<table_entry, TableEntryHash, std::equal_to<>> strings;
+    // Statistics are kept separately so that cache_size() never has to take the lock (it is
+    // called from the GC callback, possibly while another thread holds it).
+    std::atomic<std::size_t> count = 0, bytes = 0;
+};
+
+auto &cache() {
+    static std::array<cache_shard, cache_shards> g_cache;
 
     return g_cache;
 }
 
+cache_shard &shard_for(std::string_view s) {
+    std::size_t h = TableEntryHash()(s);
+    return cache()[h >> (sizeof(h) * 8 - cache_shard_bits)];
+}
+
 const char *save_to_cache(const char *string, std::size_t length, table_entry_flags flags) {
+    auto &shard = shard_for(std::string_view(string, length));
+    std::lock_guard<std::mutex> guard(shard.lock);
     // Checks if string is already cached and if not, calls ctor to construct in
     // place.  As a result, only a single lookup is performed regardless whether
     // entry is in cache or not.
-    return cache()
+    return shard.strings
         .lazy_emplace(table_entry(string, length, table_entry_flags::no_need_copy),
-                      [string, length, flags](const auto &ctor) { ctor(string, length, flags); })
+                      [&shard, string, length, flags](const auto &ctor) {
+                          ctor(string, length, flags);
+                          shard.count.fetch_add(1, std::memory_order_relaxed);
+                          shard.bytes.fetch_add(sizeof(table_entry) + length,
+                                                std::memory_order_relaxed);
+                      })
         ->string();
 }
 
 }  // namespace
 
-bool cstring::is_cached(std::string_view s) { return cache().contains(s); }
+bool cstring::is_cached(std::string_view s) {
+    auto &shard = shard_for(s);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.strings.contains(s);
+}
 
 cstring cstring::get_cached(std::string_view s) {
-    auto entry = cache().find(s);
-    if (entry == cache().end()) return nullptr;
+    auto &shard = shard_for(s);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto entry = shard.strings.find(s);
+    if (entry == shard.strings.end()) return nullptr;
 
     cstring res;
     res.str = entry->string();
@@ -216,11 +251,23 @@ void cstring::construct_from_literal(const char *string, std::size_t length) {
 
 size_t cstring::cache_size(size_t &count) {
     size_t rv = 0;
-    count = cache().size();
-    for (auto &s : cache()) rv += sizeof(s) + s.length();
+    count = 0;
+    for (size_t shard = 0; shard < cache_shards; ++shard) {
+        size_t shard_count;
+        rv += cache_size(shard, shard_count);
+        count += shard_count;
+    }
     return rv;
 }
 
+size_t cstring::cache_shard_count() { return cache_shards; }
+
+size_t cstring::cache_size(size_t shard, size_t &count) {
+    auto &s = cache().at(shard);
+    count = s.count.load(std::memory_order_relaxed);
+    return s.bytes.load(std::memory_order_relaxed);
+}
+
 bool cstring::startsWith(std::string_view prefix) const {
     if (prefix.empty()) return true;
     return size() >= prefix.size() && memcmp(str, prefix.data(), prefix.size()) == 0;
@@ -54,8 +54,8 @@ limitations under the License.
  *     std::string.
  *   - Interned strings can never be freed, so they'll stick around for the
  *     lifetime of the program.
- *   - The string interning cstring performs is currently not threadsafe, so you
- *     can't safely use cstrings off the main thread.
+ *   - Interning takes a lock (the table is sharded, so threads interning different
+ *     strings rarely contend); converting to cstring in a hot loop is still best avoided.
  *
  * Given these tradeoffs, the general rule of thumb to follow is that you should
  * try to convert strings to cstrings early and keep them in that form. That
@@ -299,6 +299,11 @@ class cstring {
     /// @return the total size in bytes of all interned strings. @count is set
     /// to the total number of interned strings.
     static size_t cache_size(size_t &count);
+    /// @return the number of shards the intern table is split into.
+    static size_t cache_shard_count();
+    /// @return the size in bytes of the strings interned in shard @shard. @count is set
+    /// to the number of strings in that shard.
+    static size_t cache_size(size_t shard, size_t &count);
 
     /// Convert the cstring to uppercase.
     cstring toUpper() const;
@@ -20,6 +20,9 @@ limitations under the License.
 #include <iostream>
 #include <ostream>
 #include <set>
+#ifdef MULTITHREAD
+#include <mutex>
+#endif  // MULTITHREAD
 #include <type_traits>
 #include <unordered_map>
 
@@ -82,6 +85,18 @@ class ErrorReporter {
     /// retrieve the format from the error catalog
     cstring get_error_name(int errorCode) { return ErrorCatalog::getCatalog().getName(errorCode); }
 
+    /// Held while a diagnostic is reported, as threads share the reporter of their compile
+    /// context.  The mutex is static because compile contexts copy their reporter.
+    struct ReportLock {
+#ifdef MULTITHREAD
+        static std::recursive_mutex &mutex() {
+            static std::recursive_mutex lock;
+            return lock;
+        }
+        std::lock_guard<std::recursive_mutex> guard{mutex()};
+#endif  // MULTITHREAD
+    };
+
  public:
     ErrorReporter()
         : infoCount(0),
@@ -113,6 +128,7 @@ class ErrorReporter {
     template <class T, typename = decltype(std::declval<T>()->getSourceInfo()), typename... Args>
     void diagnose(DiagnosticAction action, const int errorCode, const char *format,
                   const char *suffix, T node, Args &&...args) {
+        [[maybe_unused]] ReportLock lock;
         if (!node || error_reported(errorCode, node->getSourceInfo())) return;
 
         if (cstring name = get_error_name(errorCode))
@@ -125,6 +141,7 @@ class ErrorReporter {
     template <typename... Args>
     void diagnose(DiagnosticAction action, const int errorCode, const char *format,
                   const char *suffix, Args &&...args) {
+        [[maybe_unused]] ReportLock lock;
         if (cstring name = get_error_name(errorCode))
             diagnose(getDiagnosticAction(errorCode, name, action), name.c_str(), format, suffix,
                      std::forward<Args>(args)...);
@@ -138,6 +155,7 @@ class ErrorReporter {
     void diagnose(DiagnosticAction action, const char *diagnosticName, const char *format,
                   const char *suffix, Args &&...args) {
         if (action == DiagnosticAction::Ignore) return;
+        [[maybe_unused]] ReportLock lock;
 
         ErrorMessage::MessageType msgType = ErrorMessage::MessageType::None;
         if (action == DiagnosticAction::Info) {
@@ -194,6 +212,7 @@ class ErrorReporter {
     /// position information provided by Bison.
     template <typename T>
     void parser_error(const Util::SourceInfo &location, const T &message) {
+        [[maybe_unused]] ReportLock lock;
         errorCount++;
         std::stringstream ss;
         ss << message;
@@ -209,6 +228,7 @@ class ErrorReporter {
      */
     template <typename... Args>
     void parser_error(const Util::InputSources *sources, const char *fmt, Args &&...args) {
+        [[maybe_unused]] ReportLock lock;
         errorCount++;
 
         Util::SourcePosition position = sources->getCurrentPosition();
@@ -29,14 +29,21 @@ limitations under the License.
 #endif
 
 #if HAVE_LIBGC
+#if defined(MULTITHREAD) && !defined(GC_THREADS)
+// Needed for the thread registration API; we register threads explicitly.
+#define GC_THREADS 1
+#define GC_NO_THREAD_REDIRECTS 1
+#endif
 #include <gc/gc.h>
 #include <gc/gc_cpp.h>
 #include <gc/gc_mark.h>
 #endif /* HAVE_LIBGC */
 #include <sys/mman.h>
 
+#include <atomic>
 #include <cstddef>
 #include <cstring>
+#include <mutex>
 #include <new>
 
 #include "absl/debugging/stacktrace.h"
@@ -47,6 +54,9 @@ limitations under the License.
 
 using namespace P4;
 
+static std::atomic<bool> counting_allocs = false;
+static std::atomic<size_t> counted_bytes = 0;
+
 // One can disable the GC, e.g., to run under Valgrind, by editing config.h or toggling
 // -DENABLE_GC=OFF in CMake.
 #if HAVE_LIBGC
@@ -58,14 +68,17 @@ static char emergency_pool[16 * 1024];
 static char *emergency_ptr;
 
 static alloc_trace_cb_t trace_cb;
-static bool tracing = false;
-#define TRACE_ALLOC(size)                                  \
-    if (trace_cb.fn && !tracing) {                         \
-        void *buffer[ALLOC_TRACE_DEPTH];                   \
-        tracing = true;                                    \
-        absl::GetStackTrace(buffer, ALLOC_TRACE_DEPTH, 1); \
-        trace_cb.fn(trace_cb.arg, buffer, size);           \
-        tracing = false;                                   \
+static thread_local bool tracing = false;
+#define TRACE_ALLOC(size)                                         \
+    if (counting_allocs.load(std::memory_order_relaxed)) {        \
+        counted_bytes.fetch_add(size, std::memory_order_relaxed); \
+    }                                                             \
+    if (trace_cb.fn && !tracing) {                                \
+        void *buffer[ALLOC_TRACE_DEPTH];                          \
+        tracing = true;                                           \
+        absl::GetStackTrace(buffer, ALLOC_TRACE_DEPTH, 1);        \
+        trace_cb.fn(trace_cb.arg, buffer, size);                  \
+        tracing = false;                                          \
     }
 
 static void maybe_initialize_gc() {
@@ -76,11 +89,42 @@ static void maybe_initialize_gc() {
     }
 }
 
+namespace {
+
+// Per-thread free lists used while a ThreadLocalAllocCache is alive, one per 16-byte size
+// class.  The list heads live in an uncollectable object so that the collector scans them:
+// cached objects that have not been handed out yet must stay reachable, or they would be
+// reclaimed and handed out a second time.
+constexpr size_t tlc_granule = 16;
+constexpr size_t tlc_max_size = 512;
+
+struct tl_free_lists {
+    void *head[tlc_max_size / tlc_granule + 1];
+};
+
+thread_local tl_free_lists *tl_cache = nullptr;
+thread_local int tl_cache_depth = 0;
+
+void *tl_cache_alloc(size_t size) {
+    if (!tl_cache || size > tlc_max_size) return nullptr;
+    size_t idx = (size + tlc_granule - 1) / tlc_granule;
+    void *&head = tl_cache->head[idx];
+    // Take the allocation lock once to grab a whole batch of objects of this size.
+    if (!head && !(head = GC_malloc_many(idx * tlc_granule))) return nullptr;
+    void *rv = head;
+    head = GC_NEXT(rv);
+    GC_NEXT(rv) = nullptr;
+    return rv;
+}
+
+}  // namespace
+
 void *operator new(std::size_t size) {
     TRACE_ALLOC(size)
 
     maybe_initialize_gc();
-    auto *rv = ::operator new(size, UseGC, 0, 0);
+    auto *rv = tl_cache_alloc(size);
+    if (!rv) rv = ::operator new(size, UseGC, 0, 0);
     if (!rv && emergency_ptr && emergency_ptr + size < emergency_pool + sizeof(emergency_pool)) {
         rv = emergency_ptr;
         size = (size + 15) / 16 * 16;  // align to 16 bytes
@@ -99,7 +143,8 @@ void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
     maybe_initialize_gc();
     // FIXME: Call nothrow operator new from libgc with suitable new libgc
     // versions
-    auto *rv = ::operator new(size, UseGC, 0, 0);
+    auto *rv = tl_cache_alloc(size);
+    if (!rv) rv = ::operator new(size, UseGC, 0, 0);
     if (!rv && emergency_ptr && emergency_ptr + size < emergency_pool + sizeof(emergency_pool)) {
         rv = emergency_ptr;
         size = (size + 15) / 16 * 16;  // align to 16 bytes
@@ -321,6 +366,48 @@ void setup_gc_logging() {
 #endif /* HAVE_LIBGC */
 }
 
+ThreadLocalAllocCache::ThreadLocalAllocCache() {
+#if HAVE_LIBGC
+    if (tl_cache_depth++ == 0) {
+        maybe_initialize_gc();
+        tl_cache = static_cast<tl_free_lists *>(GC_MALLOC_UNCOLLECTABLE(sizeof(tl_free_lists)));
+    }
+#endif
+}
+
+ThreadLocalAllocCache::~ThreadLocalAllocCache() {
+#if HAVE_LIBGC
+    if (--tl_cache_depth == 0) {
+        // Any objects still cached become unreachable and are reclaimed by the next collection.
+        GC_FREE(tl_cache);
+        tl_cache = nullptr;
+    }
+#endif
+}
+
+GCThreadRegistration::GCThreadRegistration() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    static std::once_flag allow_register;
+    std::call_once(allow_register, [] {
+        maybe_initialize_gc();
+        GC_allow_register_threads();
+    });
+    GC_stack_base sb;
+    GC_get_stack_base(&sb);
+    GC_register_my_thread(&sb);
+#endif
+}
+
+GCThreadRegistration::~GCThreadRegistration() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    GC_unregister_my_thread();
+#endif
+}
+
+void count_allocations(bool enable) { counting_allocs.store(enable, std::memory_order_relaxed); }
+
+size_t allocated_bytes() { return counted_bytes.load(std::memory_order_relaxed); }
+
 size_t gc_mem_inuse(size_t *max) {
 #if HAVE_LIBGC
     GC_word heapsize, heapfree;
@@ -31,4 +31,39 @@ struct alloc_trace_cb_t {
 alloc_trace_cb_t set_alloc_trace(alloc_trace_cb_t cb);
 alloc_trace_cb_t set_alloc_trace(void (*fn)(void *arg, void **pc, size_t sz), void *arg);
 
+/// Starts or stops counting the bytes allocated by all threads.  Unlike an alloc_trace
+/// callback, counting takes no stack trace, so it is cheap enough to leave enabled while
+/// timing.  Only counts anything when built with libgc.
+void count_allocations(bool enable);
+/// @returns the number of bytes counted so far.
+size_t allocated_bytes();
+
+/// While an instance is alive, small `operator new` allocations made by the current thread are
+/// served from thread-private free lists that are refilled in batches (GC_malloc_many).  The
+/// global GC allocation lock is then taken once per batch rather than once per object, which
+/// lets worker threads allocate IR nodes and scratch objects without serializing on each other.
+/// Objects handed out are ordinary collectable objects.  Instances may nest; the cache is
+/// released when the outermost one is destroyed.  This is a no-op when built without libgc.
+class ThreadLocalAllocCache {
+    ThreadLocalAllocCache(const ThreadLocalAllocCache &) = delete;
+    ThreadLocalAllocCache &operator=(const ThreadLocalAllocCache &) = delete;
+
+ public:
+    ThreadLocalAllocCache();
+    ~ThreadLocalAllocCache();
+};
+
+/// Registers the calling thread with the collector for the lifetime of the object, so that
+/// its stack is scanned for roots while it allocates.  Threads other than the main thread
+/// must hold one before touching GC-allocated memory.  Only does anything in MULTITHREAD
+/// builds.
+class GCThreadRegistration {
+    GCThreadRegistration(const GCThreadRegistration &) = delete;
+    GCThreadRegistration &operator=(const GCThreadRegistration &) = delete;
+
+ public:
+    GCThreadRegistration();
+    ~GCThreadRegistration();
+};
+
 #endif /* LIB_GC_H_ */
@@ -33,11 +33,38 @@ cstring IJson::toString() const {
 
 void IJson::dump() const { std::cout << toString(); }
 
+void IJson::serialize(std::ostream &out) const {
+    JsonWriter writer(out);
+    write(writer);
+}
+
 JsonValue *JsonValue::null = new JsonValue();
 
-JsonValue::JsonValue(long long v) : tag(Kind::Integer), intValue(v) {}
+JsonValue::JsonValue(big_int v) : tag(Kind::Integer), smallInt(0) {
+    if (v >= std::numeric_limits<int64_t>::min() && v <= std::numeric_limits<int64_t>::max()) {
+        smallInt = static_cast<int64_t>(v);
+    } else {
+        isBig = true;
+        bigInt = new big_int(v);
+    }
+}
+
+JsonValue::JsonValue(unsigned long v) : JsonValue(static_cast<unsigned long long>(v)) {}
+
+JsonValue::JsonValue(unsigned long long v) : tag(Kind::Integer), smallInt(0) {
+    if (v <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+        smallInt = static_cast<int64_t>(v);
+    } else {
+        isBig = true;
+        bigInt = new big_int(v);
+    }
+}
+
+double JsonValue::integerAsDouble() const {
+    return isBig ? static_cast<double>(*bigInt) : static_cast<double>(smallInt);
+}
 
-JsonValue::JsonValue(unsigned long long v) : tag(Kind::Integer), intValue(v) {}
+void JsonValue::write(JsonWriter &writer) const { writer.value(*this); }
 
 void JsonValue::serialize(std::ostream &out) const {
     switch (tag) {
@@ -45,7 +72,10 @@ void JsonValue::serialize(std::ostream &out) const {
             out << "\"" << str << "\"";
             break;
         case Kind::Integer:
-            out << intValue;
+            if (isBig)
+                out << *bigInt;
+            else
+                out << smallInt;
             break;
         case Kind::Float:
             out << floatValue;
@@ -63,11 +93,11 @@ void JsonValue::serialize(std::ostream &out) const {
 }
 
 bool JsonValue::operator==(const big_int &v) const {
-    return tag == Kind::Integer ? v == intValue : false;
+    return tag == Kind::Integer ? v == getIntValue() : false;
 }
 bool JsonValue::operator==(const double &v) const {
     return tag == Kind::Float     ? floatValue == v
-           : tag == Kind::Integer ? static_cast<double>(intValue) == v
+           : tag == Kind::Integer ? integerAsDouble() == v
                                   : false;
 }
 bool JsonValue::operator==(const float &v) const { return *this == static_cast<double>(v); }
@@ -93,7 +123,9 @@ bool JsonValue::operator==(const JsonValue &other) const {
         case Kind::String:
             return str == other.str;
         case Kind::Integer:
-            return intValue == other.intValue;
+            // Values are stored inline whenever they fit, so equal values have the same form.
+            if (isBig != other.isBig) return false;
+            return isBig ? *bigInt == *other.bigInt : smallInt == other.smallInt;
         case Kind::Float:
             return floatValue == other.floatValue;
         case Kind::True:
@@ -105,28 +137,10 @@ bool JsonValue::operator==(const JsonValue &other) const {
     }
 }
 
-void JsonArray::serialize(std::ostream &out) const {
-    bool isSmall = true;
-    for (auto v : *this) {
-        if (!v->is<JsonValue>()) isSmall = false;
-    }
-    out << "[";
-    if (!isSmall) out << IndentCtl::indent;
-    bool first = true;
-    for (auto v : *this) {
-        if (!first) {
-            out << ",";
-            if (isSmall) out << " ";
-        }
-        if (!isSmall) out << IndentCtl::endl;
-        if (v == nullptr)
-            out << "null";
-        else
-            v->serialize(out);
-        first = false;
-    }
-    if (!isSmall) out << IndentCtl::unindent << IndentCtl::endl;
-    out << "]";
+void JsonArray::write(JsonWriter &writer) const {
+    writer.beginArray();
+    for (auto v : *this) writer.value(v);
+    writer.endArray();
 }
 
 bool JsonValue::getBool() const {
@@ -141,7 +155,7 @@ cstring JsonValue::getString() const {
 
 big_int JsonValue::getIntValue() const {
     if (!isInteger()) throw std::logic_error("Not an integer");
-    return intValue;
+    return isBig ? *bigInt : big_int(smallInt);
 }
 
 double JsonValue::getFloatValue() const {
@@ -150,9 +164,10 @@ double JsonValue::getFloatValue() const {
 }
 
 int JsonValue::getInt() const {
-    auto val = getIntValue();
-    if (val < INT_MIN || val > INT_MAX) throw std::logic_error("Value too large for int");
-    return static_cast<int>(val);
+    if (!isInteger()) throw std::logic_error("Not an integer");
+    if (isBig || smallInt < INT_MIN || smallInt > INT_MAX)
+        throw std::logic_error("Value too large for int");
+    return static_cast<int>(smallInt);
 }
 
 JsonArray *JsonArray::append(IJson *value) {
@@ -160,20 +175,13 @@ JsonArray *JsonArray::append(IJson *value) {
     return this;
 }
 
-void JsonObject::serialize(std::ostream &out) const {
-    out << "{" << IndentCtl::indent;
-    bool first = true;
+void JsonObject::write(JsonWriter &writer) const {
+    writer.beginObject();
     for (auto &it : *this) {
-        if (!first) out << ",";
-        first = false;
-        out << IndentCtl::endl;
-        out << "\"" << it.first << "\"" << " : ";
-        if (it.second == nullptr)
-            out << "null";
-        else
-            it.second->serialize(out);
+        writer.key(it.first.string_view());
+        writer.value(it.second);
     }
-    out << IndentCtl::unindent << IndentCtl::endl << "}";
+    writer.endObject();
 }
 
 JsonObject *JsonObject::emplace(cstring label, IJson *value) {
@@ -210,4 +218,121 @@ JsonObject *JsonObject::emplace_non_null(cstring label, IJson *value) {
     return this;
 }
 
+JsonFragment::JsonFragment(const IJson *json) {
+    if (!json->is<JsonObject>() && !json->is<JsonArray>())
+        throw std::logic_error("JSON fragment must be an object or an array");
+    // A fresh stream starts without indentation, which write() adds back.
+    std::stringstream str;
+    json->serialize(str);
+    text = str.str();
+}
+
+void JsonFragment::write(JsonWriter &writer) const { writer.fragment(text); }
+
+bool JsonWriter::beforeValue(const JsonValue *scalar) {
+    if (stack.empty()) return false;
+    auto &frame = stack.back();
+    if (!frame.isArray) {
+        if (!frame.hasKey) throw std::logic_error("JSON object value without a key");
+        frame.hasKey = false;
+        return false;
+    }
+    if (!frame.multiline) {
+        if (scalar) {
+            frame.pending.push_back(*scalar);
+            return true;
+        }
+        // A nested container: the array no longer fits on one line.
+        breakArray(frame);
+    }
+    if (frame.count++ > 0) out << ",";
+    out << IndentCtl::endl;
+    return false;
+}
+
+void JsonWriter::breakArray(Frame &frame) {
+    frame.multiline = true;
+    out << "[" << IndentCtl::indent;
+    for (const auto &v : frame.pending) {
+        if (frame.count++ > 0) out << ",";
+        out << IndentCtl::endl;
+        v.serialize(out);
+    }
+    frame.pending.clear();
+}
+
+JsonWriter &JsonWriter::beginObject() {
+    beforeValue(nullptr);
+    out << "{" << IndentCtl::indent;
+    stack.push_back({false});
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject() {
+    if (stack.empty() || stack.back().isArray || stack.back().hasKey)
+        throw std::logic_error("Unbalanced JSON object");
+    stack.pop_back();
+    out << IndentCtl::unindent << IndentCtl::endl << "}";
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray() {
+    beforeValue(nullptr);
+    // The opening bracket is written once the layout of the array is known.
+    stack.push_back({true});
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray() {
+    if (stack.empty() || !stack.back().isArray) throw std::logic_error("Unbalanced JSON array");
+    auto &frame = stack.back();
+    if (frame.multiline) {
+        out << IndentCtl::unindent << IndentCtl::endl << "]";
+    } else {
+        out << "[";
+        const char *sep = "";
+        for (const auto &v : frame.pending) {
+            out << sep;
+            v.serialize(out);
+            sep = ", ";
+        }
+        out << "]";
+    }
+    stack.pop_back();
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(std::string_view label) {
+    if (stack.empty() || stack.back().isArray || stack.back().hasKey)
+        throw std::logic_error("JSON key outside of an object");
+    auto &frame = stack.back();
+    if (frame.count++ > 0) out << ",";
+    out << IndentCtl::endl << "\"" << label << "\"" << " : ";
+    frame.hasKey = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const JsonValue &value) {
+    if (!beforeValue(&value)) value.serialize(out);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const IJson *json) {
+    if (json == nullptr) return value(JsonValue());
+    json->write(*this);
+    return *this;
+}
+
+JsonWriter &JsonWriter::fragment(std::string_view text) {
+    beforeValue(nullptr);
+    for (size_t start = 0;;) {
+        auto end = text.find('\n', start);
+        out << text.substr(start, end - start);
+        if (end == std::string_view::npos) break;
+        out << IndentCtl::endl;
+        start = end + 1;
+    }
+    return *this;
+}
+
 }  // namespace P4::Util
@@ -17,8 +17,12 @@ limitations under the License.
 #ifndef LIB_JSON_H_
 #define LIB_JSON_H_
 
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -38,16 +42,22 @@ class TestJson;
 
 namespace P4::Util {
 
+class JsonWriter;
+
 class IJson : public ICastable {
  public:
     virtual ~IJson() {}
-    virtual void serialize(std::ostream &out) const = 0;
+    virtual void serialize(std::ostream &out) const;
+    /// Emits this value through @p writer.
+    virtual void write(JsonWriter &writer) const = 0;
     cstring toString() const;
     void dump() const;
 
     DECLARE_TYPEINFO(IJson);
 };
 
+/// A scalar JSON value.  Integers that fit in 64 bits are stored inline;
+/// only larger ones allocate a big_int.
 class JsonValue final : public IJson {
 #ifdef P4C_GTEST_ENABLED
     FRIEND_TEST(Util, Json);
@@ -55,35 +65,41 @@ class JsonValue final : public IJson {
 
  public:
     enum Kind { String, Integer, Float, True, False, Null };
-    JsonValue() : tag(Kind::Null) {}
-    JsonValue(bool b) : tag(b ? Kind::True : Kind::False) {}         // NOLINT
-    JsonValue(big_int v) : tag(Kind::Integer), intValue(v) {}        // NOLINT
-    JsonValue(int v) : tag(Kind::Integer), intValue(v) {}            // NOLINT
-    JsonValue(long v) : tag(Kind::Integer), intValue(v) {}           // NOLINT
-    JsonValue(long long v);                                          // NOLINT
-    JsonValue(unsigned v) : tag(Kind::Integer), intValue(v) {}       // NOLINT
-    JsonValue(unsigned long v) : tag(Kind::Integer), intValue(v) {}  // NOLINT
-    JsonValue(unsigned long long v);                                 // NOLINT
-    JsonValue(double v) : tag(Kind::Float), floatValue(v) {}         // NOLINT
-    JsonValue(float v) : tag(Kind::Float), floatValue(v) {}          // NOLINT
-    JsonValue(cstring s) : tag(Kind::String), str(s) {}              // NOLINT
+    JsonValue() : tag(Kind::Null), smallInt(0) {}
+    JsonValue(bool b) : tag(b ? Kind::True : Kind::False), smallInt(0) {}  // NOLINT
+    JsonValue(big_int v);                                                   // NOLINT
+    JsonValue(int v) : tag(Kind::Integer), smallInt(v) {}                   // NOLINT
+    JsonValue(long v) : tag(Kind::Integer), smallInt(v) {}                  // NOLINT
+    JsonValue(long long v) : tag(Kind::Integer), smallInt(v) {}             // NOLINT
+    JsonValue(unsigned v) : tag(Kind::Integer), smallInt(v) {}              // NOLINT
+    JsonValue(unsigned long v);                                             // NOLINT
+    JsonValue(unsigned long long v);                                        // NOLINT
+    JsonValue(double v) : tag(Kind::Float), floatValue(v) {}                // NOLINT
+    JsonValue(float v) : tag(Kind::Float), floatValue(v) {}                 // NOLINT
+    JsonValue(cstring s) : tag(Kind::String), str(s) {}                     // NOLINT
     // FIXME: replace these two ctors with std::string view, cannot do now as
     // std::string is implicitly convertible to cstring
     JsonValue(const char *s) : tag(Kind::String), str(s) {}         // NOLINT
     JsonValue(const std::string &s) : tag(Kind::String), str(s) {}  // NOLINT
     void serialize(std::ostream &out) const override;
+    void write(JsonWriter &writer) const override;
 
     bool operator==(const big_int &v) const;
     // Integer types
     template <typename T, typename std::enable_if_t<std::is_integral_v<T>, int> = 0>
     bool operator==(const T &v) const {
-        if (tag == Kind::Integer) return intValue == v;
-        return false;
+        if (tag != Kind::Integer) return false;
+        if (isBig) return *bigInt == v;
+        if constexpr (std::is_signed_v<T>) {
+            return smallInt == static_cast<int64_t>(v);
+        } else {
+            return smallInt >= 0 && static_cast<uint64_t>(smallInt) == static_cast<uint64_t>(v);
+        }
     }
 
     template <typename T, typename std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
     bool operator==(const T &v) const {
-        if (tag == Kind::Integer) return static_cast<double>(intValue) == static_cast<double>(v);
+        if (tag == Kind::Integer) return integerAsDouble() == static_cast<double>(v);
         if (tag == Kind::Float) return floatValue == static_cast<double>(v);
         return false;
     }
@@ -112,15 +128,21 @@ class JsonValue final : public IJson {
     static JsonValue *null;
 
  private:
-    JsonValue(Kind kind) : tag(kind) {
+    JsonValue(Kind kind) : tag(kind), smallInt(0) {
         if (kind == Kind::String || kind == Kind::Integer || kind == Kind::Float)
             throw std::logic_error("Incorrect constructor called");
     }
+    double integerAsDouble() const;
 
     const Kind tag;
-    const big_int intValue = 0;
-    const double floatValue = 0.0;
-    const cstring str = cstring::empty;
+    /// True if an Integer does not fit in 64 bits and is stored in bigInt.
+    bool isBig = false;
+    union {
+        int64_t smallInt;
+        const big_int *bigInt;
+        double floatValue;
+        cstring str;
+    };
 
     DECLARE_TYPEINFO(JsonValue, IJson);
 };
@@ -129,7 +151,7 @@ class JsonArray final : public IJson, public std::vector<IJson *> {
     friend class Test::TestJson;
 
  public:
-    void serialize(std::ostream &out) const override;
+    void write(JsonWriter &writer) const override;
     JsonArray *clone() const { return new JsonArray(*this); }
     JsonArray *append(IJson *value);
     JsonArray *append(big_int v) {
@@ -181,7 +203,7 @@ class JsonObject final : public IJson, public string_map<IJson *> {
 
  public:
     JsonObject() = default;
-    void serialize(std::ostream &out) const override;
+    void write(JsonWriter &writer) const override;
     JsonObject *emplace_non_null(cstring label, IJson *value);
 
     JsonObject *emplace(cstring label, IJson *value);
@@ -204,6 +226,68 @@ class JsonObject final : public IJson, public string_map<IJson *> {
     DECLARE_TYPEINFO(JsonObject, IJson);
 };
 
+/// A JSON object or array that was rendered to text as soon as it was
+/// complete, so that its tree need not be kept until the document that holds
+/// it is serialized.  It is written with the same layout as the tree.
+class JsonFragment final : public IJson {
+    std::string text;
+
+ public:
+    /// Renders @p json, which must be an object or an array.
+    explicit JsonFragment(const IJson *json);
+    void write(JsonWriter &writer) const override;
+
+    DECLARE_TYPEINFO(JsonFragment, IJson);
+};
+
+/// Writes a JSON document to a stream as it is produced, without building
+/// an IJson tree first.  Calls must be properly nested: every key in an
+/// object is followed by exactly one value, which may be a nested object
+/// or array.  The output has the same layout as IJson::serialize: arrays
+/// holding only scalars are written on one line, everything else is
+/// indented with IndentCtl.
+class JsonWriter {
+    std::ostream &out;
+
+    struct Frame {
+        bool isArray;
+        /// Number of elements or keys written so far.
+        size_t count = 0;
+        /// For arrays: true once the array is written one element per line.
+        bool multiline = false;
+        /// For single-line arrays: the scalars seen so far, not yet written.
+        std::vector<JsonValue> pending;
+        /// For objects: true if a key was written and awaits its value.
+        bool hasKey = false;
+    };
+    std::vector<Frame> stack;
+
+    /// Prepares the output for a value in the current context.  @p scalar is
+    /// the value if it is a scalar, and nullptr otherwise.  @returns true if
+    /// the scalar was buffered for a single-line array and must not be written.
+    bool beforeValue(const JsonValue *scalar);
+    void breakArray(Frame &frame);
+
+ public:
+    explicit JsonWriter(std::ostream &out) : out(out) {}
+    JsonWriter(const JsonWriter &) = delete;
+    JsonWriter &operator=(const JsonWriter &) = delete;
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    JsonWriter &beginArray();
+    JsonWriter &endArray();
+    JsonWriter &key(std::string_view label);
+    JsonWriter &value(const JsonValue &value);
+    /// Writes the tree @p json; nullptr is written as null.
+    JsonWriter &value(const IJson *json);
+    /// Writes an object or array that was rendered on its own, at the
+    /// indentation of the current context.
+    JsonWriter &fragment(std::string_view text);
+    /// True if all objects and arrays have been closed.
+    bool done() const { return stack.empty(); }
+};
+
 }  // namespace P4::Util
 
 #endif /* LIB_JSON_H_ */
@@ -42,7 +42,8 @@ extern int maximumLogLevel;
 
 // Used to restrict logging to a specific IR context.
 extern bool enableLoggingGlobally;
-extern bool enableLoggingInContext;  // if enableLoggingGlobally is true, this is ignored.
+// if enableLoggingGlobally is true, this is ignored.  Per thread, like the visitors that set it.
+extern thread_local bool enableLoggingInContext;
 
 // Look up the log level of @file.
 int fileLogLevel(const char *file);
@@ -90,6 +91,10 @@ inline bool fileLogLevelIsAtLeast(const char *file, int level) {
     return Detail::fileLogLevel(file) >= level;
 }
 
+// Whether any file may log at @level or above. Cheaper than fileLogLevelIsAtLeast, and
+// conservative: it stays true once such a level has been requested for some file.
+inline bool anyFileLogLevelIsAtLeast(int level) { return Detail::maximumLogLevel >= level; }
+
 // Process @spec and update the log level requested for the appropriate file.
 void addDebugSpec(const char *spec);
 
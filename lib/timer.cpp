@@ -4,6 +4,7 @@
 #include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
 #include <cstdint>
 #include <memory>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
@@ -60,6 +61,13 @@ struct RootCounter {
         return ROOT;
     }
 
+    /// Timers are only recorded on the thread that used them first (normally the main thread);
+    /// timers started on other threads are ignored.
+    static bool onTimerThread() {
+        static const std::thread::id owner = std::this_thread::get_id();
+        return owner == std::this_thread::get_id();
+    }
+
     CounterEntry *getCurrent() const { return current; }
 
     void setCurrent(CounterEntry *c) { current = c; }
@@ -103,7 +111,8 @@ struct ScopedTimerCtx {
 };
 #pragma GCC diagnostic pop
 
-ScopedTimer::ScopedTimer(const char *name) : ctx(new ScopedTimerCtx(name)) {}
+ScopedTimer::ScopedTimer(const char *name)
+    : ctx(RootCounter::onTimerThread() ? new ScopedTimerCtx(name) : nullptr) {}
 
 ScopedTimer::~ScopedTimer() = default;
 
@@ -244,15 +244,22 @@ SymbolicStruct::SymbolicStruct(const IR::Type_StructLike *type, bool uninitializ
     : SymbolicValue(type) {
     CHECK_NULL(type);
     CHECK_NULL(factory);
+    fieldValue.reserve(type->fields.size());
     for (auto f : type->fields) {
         auto value = factory->create(f->type, uninitialized);
         fieldValue[f->name.name] = value;
     }
 }
 
+void SymbolicStruct::cloneFields(SymbolicStruct *result) const {
+    // Copying the whole field table keeps it sorted, so only the values need to be replaced.
+    result->fieldValue = fieldValue;
+    for (auto &f : result->fieldValue) f.second = f.second->clone();
+}
+
 SymbolicValue *SymbolicStruct::clone() const {
     auto result = new SymbolicStruct(type->to<IR::Type_StructLike>());
-    for (auto f : fieldValue) result->fieldValue[f.first] = f.second->clone();
+    cloneFields(result);
     return result;
 }
 
@@ -341,7 +348,7 @@ void SymbolicHeaderUnion::setAllUnknown() {
 
 SymbolicValue *SymbolicHeaderUnion::clone() const {
     auto result = new SymbolicHeaderUnion(type->to<IR::Type_HeaderUnion>());
-    for (auto f : fieldValue) result->fieldValue[f.first] = f.second->clone();
+    cloneFields(result);
     return result;
 }
 
@@ -398,7 +405,7 @@ void SymbolicHeader::setAllUnknown() {
 
 SymbolicValue *SymbolicHeader::clone() const {
     auto result = new SymbolicHeader(type->to<IR::Type_Header>());
-    for (auto f : fieldValue) result->fieldValue[f.first] = f.second->clone();
+    cloneFields(result);
     result->valid = valid->clone()->to<SymbolicBool>();
     return result;
 }
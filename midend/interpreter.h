@@ -20,6 +20,7 @@ limitations under the License.
 #include "frontends/p4/coreLibrary.h"
 #include "frontends/p4/typeMap.h"
 #include "ir/ir.h"
+#include "lib/flat_map.h"
 
 // Symbolic P4 program evaluation.
 
@@ -70,10 +71,13 @@ class SymbolicValueFactory {
 
 class ValueMap final : public IHasDbPrint {
  public:
-    std::map<const IR::IDeclaration *, SymbolicValue *> map;
+    /// Kept in a sorted vector: value maps are cloned for every state evaluated by the
+    /// interpreter, and copying a vector takes a single allocation.
+    flat_map<const IR::IDeclaration *, SymbolicValue *> map;
     ValueMap *clone() const {
         auto result = new ValueMap();
-        for (auto v : map) result->map.emplace(v.first, v.second->clone());
+        result->map = map;
+        for (auto &v : result->map) v.second = v.second->clone();
         return result;
     }
     ValueMap *filter(std::function<bool(const IR::IDeclaration *, const SymbolicValue *)> filter) {
@@ -423,7 +427,7 @@ class SymbolicStruct : public SymbolicValue {
     explicit SymbolicStruct(const IR::Type_StructLike *type) : SymbolicValue(type) {
         CHECK_NULL(type);
     }
-    std::map<cstring, SymbolicValue *> fieldValue;
+    flat_map<cstring, SymbolicValue *> fieldValue;
     SymbolicStruct(const IR::Type_StructLike *type, bool uninitialized,
                    const SymbolicValueFactory *factory);
     virtual SymbolicValue *get(const IR::Node *, cstring field) const {
@@ -445,6 +449,10 @@ class SymbolicStruct : public SymbolicValue {
     bool hasUninitializedParts() const override;
 
     DECLARE_TYPEINFO(SymbolicStruct, SymbolicValue);
+
+ protected:
+    /// Sets the fields of @p result to clones of the fields of this value.
+    void cloneFields(SymbolicStruct *result) const;
 };
 
 class SymbolicHeader : public SymbolicStruct {
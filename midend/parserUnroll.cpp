@@ -1,5 +1,8 @@
 #include "parserUnroll.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "interpreter.h"
 #include "ir/ir.h"
 #include "lib/hash.h"
@@ -61,33 +64,32 @@ struct VisitedKey {
         indexes = stateInfo->statesIndexes;
     }
 
-    /// Checks of two states to be less. If @a name < @a e.name then it returns @a true.
-    /// if @a name > @a e.name then it returns false.
-    /// If @a name is equal @a e.name then it checks the values of the headers stack indexes.
-    /// For both map of header stacks' indexes it creates map of pairs of values for each
-    /// header stack index.
-    /// If some indexes are missing then it cosiders them as -1.
-    /// Next, it continues checking each pair in a intermidiate map with the same approach
-    /// as for @a name and @a e.name.
-    bool operator<(const VisitedKey &e) const {
-        if (name < e.name) return true;
-        if (name > e.name) return false;
-        std::unordered_map<StackVariable, std::pair<size_t, size_t>, StackVariableHash> mp;
-        for (auto &i1 : indexes) {
-            mp.emplace(i1.first, std::make_pair(i1.second, -1));
-        }
-        for (auto &i2 : e.indexes) {
-            auto ref = mp.find(i2.first);
-            if (ref == mp.end())
-                mp.emplace(i2.first, std::make_pair(-1, i2.second));
-            else
-                ref->second.second = i2.second;
-        }
-        for (auto j : mp) {
-            if (j.second.first < j.second.second) return true;
-            if (j.second.first > j.second.second) return false;
+    /// Two keys are equal if they have the same state name and the same header stack indexes.
+    /// Missing indexes are considered as -1.
+    bool operator==(const VisitedKey &e) const {
+        if (name != e.name) return false;
+        auto sameIndexes = [](const StackVariableMap &l, const StackVariableMap &r) {
+            for (const auto &[var, index] : l) {
+                auto it = r.find(var);
+                size_t other = it == r.end() ? static_cast<size_t>(-1) : it->second;
+                if (index != other) return false;
+            }
+            return true;
+        };
+        return sameIndexes(indexes, e.indexes) && sameIndexes(e.indexes, indexes);
+    }
+};
+
+/// Hashes a @a VisitedKey consistently with its equality: the indexes are combined in an
+/// order-independent way and indexes equal to -1 are skipped.
+struct VisitedKeyHash {
+    size_t operator()(const VisitedKey &key) const {
+        size_t indexesHash = 0;
+        for (const auto &[var, index] : key.indexes) {
+            if (index == static_cast<size_t>(-1)) continue;
+            indexesHash += Util::hash_combine(StackVariableHash()(var), index);
         }
-        return false;
+        return Util::hash_combine(std::hash<cstring>()(key.name), indexesHash);
     }
 };
 
@@ -809,7 +811,7 @@ class ParserSymbolicInterpreter {
         startInfo->scenarioStates.insert(structure->start->name.name);
         std::vector<ParserStateInfo *> toRun;  // worklist
         toRun.push_back(startInfo);
-        std::set<VisitedKey> visited;
+        std::unordered_set<VisitedKey, VisitedKeyHash> visited;
         std::unordered_set<cstring> newStates;
         while (!toRun.empty()) {
             auto stateInfo = toRun.back();
@@ -877,6 +879,14 @@ bool ParserStructure::analyze(ReferenceMap *refMap, TypeMap *typeMap, bool unrol
 /// check reachability for usage of header stack
 bool ParserStructure::reachableHSUsage(IR::ID id, const ParserStateInfo *state) const {
     if (!state->scenarioHS.size()) return false;
+    const auto &reachebleHSoperators = reachableHSOperators(id);
+    return std::any_of(state->scenarioHS.begin(), state->scenarioHS.end(),
+                       [&](cstring hs) { return reachebleHSoperators.count(hs) != 0; });
+}
+
+const std::set<cstring> &ParserStructure::reachableHSOperators(IR::ID id) const {
+    auto cached = reachableHSOperatorsCache.find(id.name);
+    if (cached != reachableHSOperatorsCache.end()) return cached->second;
     CHECK_NULL(callGraph);
     const IR::IDeclaration *declaration = parser->states.getDeclaration(id.name);
     BUG_CHECK(declaration && declaration->is<IR::ParserState>(), "Invalid declaration %1%", id);
@@ -888,11 +898,8 @@ bool ParserStructure::reachableHSUsage(IR::ID id, const ParserStateInfo *state)
         if (iHSNames != statesWithHeaderStacks.end())
             reachebleHSoperators.insert(iHSNames->second.begin(), iHSNames->second.end());
     }
-    std::set<cstring> intersectionHSOperators;
-    std::set_intersection(state->scenarioHS.begin(), state->scenarioHS.end(),
-                          reachebleHSoperators.begin(), reachebleHSoperators.end(),
-                          std::inserter(intersectionHSOperators, intersectionHSOperators.begin()));
-    return intersectionHSOperators.size() > 0;
+    return reachableHSOperatorsCache.emplace(id.name, std::move(reachebleHSoperators))
+        .first->second;
 }
 
 void ParserStructure::addStateHSUsage(const IR::ParserState *state,
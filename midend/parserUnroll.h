@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef MIDEND_PARSERUNROLL_H_
 #define MIDEND_PARSERUNROLL_H_
 
+#include <set>
 #include <unordered_map>
 
 #include "frontends/common/resolveReferences/referenceMap.h"
@@ -166,6 +167,12 @@ class ParserStructure {
     bool reachableHSUsage(IR::ID id, const ParserStateInfo *state) const;
 
  protected:
+    /// Header stacks used in the states reachable from each state. The symbolic evaluation
+    /// asks for the same state many times, so the reachable states are only computed once.
+    mutable std::unordered_map<cstring, std::set<cstring>> reachableHSOperatorsCache;
+    /// @returns the header stacks used in the states reachable from state @p id.
+    const std::set<cstring> &reachableHSOperators(IR::ID id) const;
+
     /// evaluates rechable states with HS operations for each path.
     void evaluateReachability();
     /// add HS name which is used in a current state.
@@ -18,6 +18,12 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lib/gc.h"
+
 namespace P4::Test {
 
 using namespace P4::literals;
@@ -158,4 +164,37 @@ TEST(cstring, get_cached) {
     EXPECT_FALSE(cstring::get_cached("test").isNullOrEmpty());
 }
 
+TEST(cstring, cache_size) {
+    [[maybe_unused]] cstring test = "test"_cs;
+    size_t total_count, total = cstring::cache_size(total_count);
+    size_t sum = 0, sum_count = 0;
+    for (size_t shard = 0; shard < cstring::cache_shard_count(); ++shard) {
+        size_t count;
+        sum += cstring::cache_size(shard, count);
+        sum_count += count;
+    }
+    EXPECT_GT(total_count, 0u);
+    EXPECT_EQ(total, sum);
+    EXPECT_EQ(total_count, sum_count);
+}
+
+#ifdef MULTITHREAD
+TEST(cstring, concurrent_interning) {
+    constexpr int threads = 8, strings = 2000;
+    std::vector<std::vector<const char *>> results(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&results, t] {
+            GCThreadRegistration registration;
+            for (int i = 0; i < strings; ++i)
+                results[t].push_back(cstring("concurrent interning " + std::to_string(i)).c_str());
+        });
+    }
+    for (auto &w : workers) w.join();
+
+    for (int t = 1; t < threads; ++t) EXPECT_EQ(results[0], results[t]);
+    EXPECT_EQ(cstring("concurrent interning 42").c_str(), results[0][42]);
+}
+#endif
+
 }  // namespace P4::Test
@@ -98,3 +98,37 @@ TEST(JSON, variant) {
         EXPECT_EQ(data[i], copy[i]);
     }
 }
+
+TEST(JSON, binary) {
+    std::map<big_int, bitvec> data, copy;
+    data[big_int(1) << 100].setrange(100, 100);
+    data[-(big_int(1) << 70)] = bitvec(3);
+    data[-1] = bitvec(1);
+    data[1] = bitvec(1);
+
+    std::stringstream ss;
+    JSONGenerator(ss, false, JSONGenerator::Encoding::Binary).emit(data);
+    JSONLoader(ss) >> copy;
+
+    EXPECT_EQ(data, copy);
+}
+
+TEST(IR, DumpBinary) {
+    auto c = new IR::Constant(2);
+    IR::Expression *e1 = new IR::Add(Util::SourceInfo(), c, new IR::Neg(c));
+
+    std::stringstream text, binary;
+    JSONGenerator(text).emit(e1);
+    JSONGenerator(binary, false, JSONGenerator::Encoding::Binary).emit(e1);
+    EXPECT_LT(binary.str().size(), text.str().size());
+
+    JSONLoader loader(binary);
+    const IR::Node *e2 = nullptr;
+    loader >> e2;
+    ASSERT_NE(e2, nullptr);
+    EXPECT_TRUE(e1->equiv(*e2));
+    // The shared constant is still shared after the round trip.
+    auto *add = e2->to<IR::Add>();
+    ASSERT_NE(add, nullptr);
+    EXPECT_EQ(add->left, add->right->to<IR::Neg>()->expr);
+}
@@ -0,0 +1,138 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "frontends/common/frontendCache.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "helpers.h"
+#include "ir/ir.h"
+
+namespace P4::Test {
+
+class FrontendCacheTest : public P4CTest {
+ protected:
+    std::filesystem::path dir;
+    std::string file;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              (std::string("p4c-frontend-cache-") +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::create_directories(dir);
+        file = (dir / "program.p4").string();
+        std::ofstream(file) << "header h_t { bit<8> f; }\n"
+                               "control c(inout h_t h) { apply { h.f = 1; } }\n";
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    /// Opens the cache entry of the test program when compiled with @p extraArgs.
+    std::optional<P4::FrontendCache> open(std::vector<std::string> extraArgs) {
+        AutoCompileContext autoContext(new GTestContext);
+        auto &options = GTestContext::get().options();
+        std::vector<std::string> args = {"p4test", "--nocpp", "--frontend-cache",
+                                         (dir / "cache").string()};
+        args.insert(args.end(), extraArgs.begin(), extraArgs.end());
+        args.push_back(file);
+        std::vector<char *> argv;
+        for (auto &arg : args) argv.push_back(arg.data());
+        options.process(argv.size(), argv.data());
+        options.setInputFile();
+        return P4::FrontendCache::open(options);
+    }
+};
+
+TEST_F(FrontendCacheTest, Key) {
+    auto cache = open({});
+    ASSERT_TRUE(cache);
+    EXPECT_EQ(cache->path().parent_path(), dir / "cache");
+    EXPECT_EQ(open({})->path(), cache->path());
+
+    // Options that only select outputs of later stages do not change the key.
+    EXPECT_EQ(open({"--toJSON", (dir / "out.json").string()})->path(), cache->path());
+    EXPECT_FALSE(open({"--toJSON", (dir / "out.json").string()})->bypassed());
+
+    // Options that affect the front end do.
+    EXPECT_NE(open({"-O0"})->path(), cache->path());
+    EXPECT_NE(open({"-O0"})->path(), open({"-O2"})->path());
+    EXPECT_NE(open({"--Wdisable"})->path(), cache->path());
+    EXPECT_NE(open({"--parser-inline-opt"})->path(), cache->path());
+    EXPECT_NE(open({"--disable-annotations=hidden"})->path(), cache->path());
+
+    // So does the input.
+    std::ofstream(file, std::ios::app) << "// comment\n";
+    EXPECT_NE(open({})->path(), cache->path());
+}
+
+TEST_F(FrontendCacheTest, OutputsOfTheFrontEndBypassTheCache) {
+    EXPECT_FALSE(open({})->bypassed());
+    EXPECT_TRUE(open({"--pp", (dir / "out.p4").string()})->bypassed());
+    EXPECT_TRUE(open({"--top4", "FrontEndLast"})->bypassed());
+    EXPECT_TRUE(open({"--listFrontendPasses"})->bypassed());
+
+    AutoCompileContext autoContext(new GTestContext);
+    auto &options = GTestContext::get().options();
+    options.doNotPreprocess = true;
+    options.file = file;
+    options.frontendCacheDir = dir / "cache";
+    auto cache = P4::FrontendCache::open(options);
+    ASSERT_TRUE(cache);
+    cache->store(cache->parse(options));
+    ASSERT_NE(P4::FrontendCache::open(options)->load(), nullptr);
+
+    options.prettyPrintFile = dir / "out.p4";
+    EXPECT_EQ(P4::FrontendCache::open(options)->load(), nullptr);
+}
+
+TEST_F(FrontendCacheTest, StoreAndLoad) {
+    AutoCompileContext autoContext(new GTestContext);
+    auto &options = GTestContext::get().options();
+    options.doNotPreprocess = true;
+    options.file = file;
+    options.frontendCacheDir = dir / "cache";
+
+    auto cache = P4::FrontendCache::open(options);
+    ASSERT_TRUE(cache);
+    EXPECT_EQ(cache->load(), nullptr);
+
+    std::stringstream diagnostics;
+    BaseCompileContext::get().errorReporter().setOutputStream(&diagnostics);
+    cache->record();
+    const auto *program = cache->parse(options);
+    ASSERT_NE(program, nullptr);
+    ASSERT_EQ(program->objects.size(), 2u);
+    ::P4::warning(ErrorType::WARN_UNUSED, "%1%: front end warning", program->objects.at(0));
+    cache->store(program);
+    EXPECT_TRUE(std::filesystem::exists(cache->path()));
+    const auto warning = diagnostics.str();
+    EXPECT_NE(warning.find("front end warning"), std::string::npos);
+
+    // A hit reports the diagnostics of the run that stored the entry.
+    diagnostics.str("");
+    const auto *loaded = P4::FrontendCache::open(options)->load();
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_TRUE(program->equiv(*loaded));
+    EXPECT_EQ(diagnostics.str(), warning);
+
+    // A damaged entry is ignored rather than loaded.
+    std::ofstream(cache->path(), std::ios::trunc) << "garbage";
+    EXPECT_EQ(cache->load(), nullptr);
+}
+
+}  // namespace P4::Test
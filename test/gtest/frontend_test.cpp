@@ -4,6 +4,7 @@
 #include "frontends/common/parseInput.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/common/resolveReferences/resolveReferences.h"
+#include "frontends/p4/def_use.h"
 #include "frontends/p4/moveDeclarations.h"
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "helpers.h"
@@ -194,4 +195,91 @@ TEST_F(P4CFrontendMoveInitializers, P4ControlSrcInfo) {
     }
 }
 
+// Tests for ClearTypeMap
+struct P4CFrontendClearTypeMap : P4CFrontend {
+    P4CFrontendClearTypeMap() { addPasses({new P4::TypeInference(&typeMap, false, false)}); }
+
+    P4::TypeMap typeMap;
+};
+
+TEST_F(P4CFrontendClearTypeMap, ForgetsOnlyChangedDeclarations) {
+    std::string program = P4_SOURCE(R"(
+        header H { bit<8> f; }
+        const bit<8> a = 1;
+        const bit<8> b = a;
+        const bit<16> c = 2;
+    )");
+    const auto *prog = parseAndProcess(program);
+    ASSERT_TRUE(prog);
+    ASSERT_EQ(::P4::errorCount(), 0);
+    const auto *p4prog = prog->to<IR::P4Program>();
+    ASSERT_TRUE(p4prog);
+
+    // Replace the declaration of a.
+    auto *changed = p4prog->clone();
+    const IR::Node *b = nullptr, *c = nullptr, *h = nullptr;
+    for (auto &object : changed->objects) {
+        const auto *decl = object->to<IR::IDeclaration>();
+        ASSERT_TRUE(decl);
+        if (decl->getName().name == "a") {
+            auto *a = object->to<IR::Declaration_Constant>()->clone();
+            a->initializer = new IR::Constant(IR::Type_Bits::get(8), 3);
+            object = a;
+        } else if (decl->getName().name == "b") {
+            b = object;
+        } else if (decl->getName().name == "c") {
+            c = object;
+        } else if (decl->getName().name == "H") {
+            h = object;
+        }
+    }
+    ASSERT_TRUE(b && c && h);
+    ASSERT_TRUE(typeMap.contains(b));
+    ASSERT_TRUE(typeMap.contains(c));
+
+    changed->apply(P4::ClearTypeMap(&typeMap));
+    // b refers to a, so it has to be inferred again; c and H do not.
+    EXPECT_FALSE(typeMap.contains(b));
+    EXPECT_TRUE(typeMap.contains(c));
+    EXPECT_TRUE(typeMap.contains(h));
+
+    const auto *result = changed->apply(P4::TypeInference(&typeMap, false, false));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(::P4::errorCount(), 0);
+    EXPECT_TRUE(typeMap.contains(b));
+}
+
+// Tests for the bit vector representation of ProgramPoints
+TEST(P4CFrontendProgramPoints, MergeAndIterate) {
+    ProgramPointTable table;
+    auto *s1 = new IR::EmptyStatement();
+    auto *s2 = new IR::EmptyStatement();
+    auto *p1 = new ProgramPoints(&table, ProgramPoint(s1));
+    auto *p2 = new ProgramPoints(&table, ProgramPoint(s2));
+    auto *start = new ProgramPoints(&table, ProgramPoint::beforeStart);
+    EXPECT_EQ(table.size(), 3u);
+
+    // Numbering the same point twice yields the same number.
+    EXPECT_EQ(*p1, ProgramPoints(&table, ProgramPoint(s1)));
+
+    const auto *both = p1->merge(p2);
+    EXPECT_EQ(both->size(), 2u);
+    EXPECT_FALSE(both->containsBeforeStart());
+    // Merging a subset returns the superset itself.
+    EXPECT_EQ(both->merge(p1), both);
+    EXPECT_EQ(p2->merge(both), both);
+
+    const auto *all = both->merge(start);
+    EXPECT_TRUE(all->containsBeforeStart());
+    std::vector<const IR::Node *> lasts;
+    for (const auto &point : *all) lasts.push_back(point.last());
+    EXPECT_EQ(lasts, (std::vector<const IR::Node *>{nullptr, s1, s2}));
+
+    ProgramPoints empty;
+    empty.add(&empty);
+    EXPECT_EQ(empty.size(), 0u);
+    empty.add(p2);
+    EXPECT_EQ(empty, *p2);
+}
+
 }  // namespace P4::Test
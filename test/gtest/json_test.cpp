@@ -85,4 +85,61 @@ TEST(Util, Json) {
               obj->toString());
 }
 
+TEST(Util, JsonLargeIntegers) {
+    auto *value = new JsonValue(static_cast<unsigned long long>(~0ULL));
+    EXPECT_EQ("18446744073709551615", value->toString());
+    EXPECT_TRUE(*value == ~0ULL);
+    EXPECT_FALSE(*value == -1);
+
+    big_int big = big_int(1) << 100;
+    value = new JsonValue(big);
+    EXPECT_EQ("1267650600228229401496703205376", value->toString());
+    EXPECT_EQ(value->getIntValue(), big);
+    EXPECT_THROW(value->getInt(), std::logic_error);
+
+    // Values that fit in 64 bits compare equal however they were constructed.
+    EXPECT_TRUE(JsonValue(big_int(-7)) == JsonValue(-7));
+    EXPECT_TRUE(JsonValue(5u) == 5.0);
+}
+
+TEST(Util, JsonWriter) {
+    std::stringstream out;
+    JsonWriter writer(out);
+    writer.beginObject();
+    writer.key("x").value("x");
+    writer.key("y").beginArray().value(5).value("5").value(nullptr).endArray();
+    writer.key("z").beginArray().value(1).beginArray().value(true).endArray().endArray();
+    writer.endObject();
+    EXPECT_TRUE(writer.done());
+    EXPECT_EQ("{\n  \"x\" : \"x\",\n  \"y\" : [5, \"5\", null],\n"
+              "  \"z\" : [\n    1,\n    [true]\n  ]\n}",
+              out.str());
+
+    // Trees written through the writer have the same layout as when serialized.
+    auto *obj = new JsonObject();
+    obj->emplace("y", (new JsonArray())->append(5)->append(new JsonArray()));
+    std::stringstream tree;
+    JsonWriter(tree).value(obj);
+    EXPECT_EQ(obj->toString(), tree.str());
+
+    JsonWriter bad(out);
+    bad.beginObject();
+    EXPECT_THROW(bad.value(1), std::logic_error);
+}
+
+TEST(Util, JsonFragment) {
+    auto *inner = new JsonObject();
+    inner->emplace("a", (new JsonArray())->append(1)->append(2));
+    inner->emplace("b", (new JsonArray())->append(new JsonObject()));
+    auto *tree = new JsonObject();
+    tree->emplace("items", (new JsonArray())->append(inner)->append(3));
+
+    // A fragment is indented to where it is written, like the tree it was rendered from.
+    auto *streamed = new JsonObject();
+    streamed->emplace("items", (new JsonArray())->append(new JsonFragment(inner))->append(3));
+    EXPECT_EQ(tree->toString(), streamed->toString());
+
+    EXPECT_THROW(JsonFragment(new JsonValue(1)), std::logic_error);
+}
+
 }  // namespace P4::Util
@@ -16,6 +16,8 @@ limitations under the License.
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <google/protobuf/text_format.h>
+#include <google/protobuf/util/json_util.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <gtest/gtest.h>
 
@@ -1478,6 +1480,91 @@ TEST_F(P4Runtime, JsonSerializationPrintOptions) {
     }
 }
 
+TEST_F(P4Runtime, SerializationFormats) {
+    auto source = P4_SOURCE(P4Headers::V1MODEL, R"(
+        struct Headers { }
+        struct Metadata { }
+        parser parse(packet_in p, out Headers h, inout Metadata m,
+                     inout standard_metadata_t sm) {
+            state start { transition accept; } }
+        control verifyChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control egress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) { apply { } }
+        control computeChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control deparse(packet_out p, in Headers h) { apply { } }
+
+        control ingress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) {
+            action forward(bit<9> port) { sm.egress_spec = port; }
+
+            table t {
+                key = { sm.ingress_port : exact; }
+                actions = { forward; }
+                const entries = {
+                    1 : forward(2);
+                    2 : forward(1);
+                }
+                default_action = forward(0);
+            }
+
+            apply {
+                t.apply();
+            }
+        }
+
+        V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+                 computeChecksum(), deparse()) main;
+    )");
+    auto test = createP4RuntimeTestCase(source);
+
+    ASSERT_TRUE(test);
+    EXPECT_EQ(0U, ::P4::diagnosticCount());
+    ASSERT_EQ(2, test->entries->updates_size());
+
+    {
+        // JSON is streamed to the output; it must match MessageToJsonString.
+        std::ostringstream output;
+        test->serializeP4InfoTo(&output, P4::P4RuntimeFormat::JSON);
+        std::string expected;
+        ASSERT_TRUE(
+            google::protobuf::util::MessageToJsonString(*test->p4Info, &expected,
+                                                        test->jsonPrintOptions)
+                .ok());
+        EXPECT_EQ(expected, output.str());
+    }
+
+    {
+        std::ostringstream output;
+        test->serializeEntriesTo(&output, P4::P4RuntimeFormat::TEXT_PROTOBUF);
+        std::string expected;
+        google::protobuf::TextFormat::Printer printer;
+        printer.SetExpandAny(true);
+        ASSERT_TRUE(printer.PrintToString(*test->entries, &expected));
+        EXPECT_NE(output.str().find("# proto-message: p4.v1.WriteRequest\n\n" + expected),
+                  std::string::npos);
+    }
+
+    {
+        std::ostringstream output;
+        test->serializeP4InfoTo(&output, P4::P4RuntimeFormat::BINARY);
+        p4configv1::P4Info p4Info;
+        ASSERT_TRUE(p4Info.ParseFromString(output.str()));
+        EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(*test->p4Info, p4Info));
+    }
+
+    {
+        // Without entries, the P4Info is the same and the entries are empty.
+        auto frontendTestCase = FrontendTestCase::create(
+            source, new AnnotationParsingPolicy(new P4::ParseAnnotations()));
+        ASSERT_TRUE(frontendTestCase);
+        auto withoutEntries = P4::P4RuntimeSerializer::get()->generateP4Runtime(
+            frontendTestCase->program, defaultArch, false);
+        EXPECT_EQ(0, withoutEntries.entries->updates_size());
+        EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(*test->p4Info,
+                                                                       *withoutEntries.p4Info));
+    }
+}
+
 class P4RuntimePkgInfo : public P4CTest {
  protected:
     static std::optional<P4::P4RuntimeAPI> createTestCase(const char *annotations);
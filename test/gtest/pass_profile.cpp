@@ -0,0 +1,71 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/pass_profile.h"
+
+#include <gtest/gtest.h>
+
+#include <regex>
+#include <sstream>
+
+#include "config.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "ir/pass_manager.h"
+
+namespace P4::Test {
+
+class PassProfileTest : public P4CTest {};
+
+TEST_F(PassProfileTest, RecordsNestedPasses) {
+    PassProfiler::enable(std::filesystem::temp_directory_path() / "p4c-pass-profile.json");
+    ASSERT_NE(PassProfiler::get(), nullptr);
+
+    auto *makeConstants = new VisitFunctor([] {
+        for (int i = 0; i < 10; ++i) new IR::Constant(i);
+    });
+    makeConstants->setName("MakeConstants");
+    auto *inner = new PassManager({makeConstants});
+    inner->setName("Inner");
+    PassManager outer({inner});
+    (new IR::P4Program())->apply(outer);
+
+    std::stringstream trace, summary;
+    PassProfiler::get()->writeTrace(trace);
+    PassProfiler::get()->writeSummary(summary, 10);
+    PassProfiler::disable();
+    EXPECT_EQ(PassProfiler::get(), nullptr);
+
+    // Both passes are recorded, the nested one one level deeper, and each is charged for the
+    // nodes it created itself.
+    std::smatch match;
+    auto traceText = trace.str();
+    std::regex makeConstantsEvent(
+        R"("name":"MakeConstants".*"depth":1,.*"alloc_bytes":(\d+),.*"self_nodes":(\d+))");
+    ASSERT_TRUE(std::regex_search(traceText, match, makeConstantsEvent));
+#if HAVE_LIBGC
+    EXPECT_GE(std::stoull(match[1].str()), 10 * sizeof(IR::Constant));
+#endif
+    EXPECT_GE(std::stoll(match[2].str()), 10);
+    ASSERT_TRUE(std::regex_search(
+        traceText, match, std::regex(R"("name":"Inner".*"depth":0,.*"self_nodes":(\d+))")));
+    EXPECT_EQ(std::stoll(match[1].str()), 0);
+
+    // The summary lists each pass once, with its number of runs.
+    auto summaryText = summary.str();
+    EXPECT_TRUE(std::regex_search(summaryText, std::regex(R"(\nMakeConstants +1 )")));
+    EXPECT_TRUE(std::regex_search(summaryText, std::regex(R"(\nInner +1 )")));
+}
+
+}  // namespace P4::Test
@@ -0,0 +1,106 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "frontends/common/preprocessor.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+namespace P4::Test {
+
+class Preprocessor : public ::testing::Test {
+ protected:
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              (std::string("p4c-preprocessor-") +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::create_directories(dir / "include");
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    std::string write(const std::string &name, const std::string &contents) {
+        auto path = dir / name;
+        std::ofstream(path) << contents;
+        return path.string();
+    }
+};
+
+TEST_F(Preprocessor, Macros) {
+    auto file = write("macros.p4",
+                      "#define WIDTH 16\n"
+                      "#define TYPE bit<WIDTH>\n"
+                      "TYPE x; // WIDTH\n"
+                      "#undef WIDTH\n"
+                      "TYPE y;\n");
+    P4::Preprocessor preprocessor;
+    auto result = preprocessor.process(file);
+    ASSERT_TRUE(result);
+    EXPECT_EQ("# 1 \"" + file + "\"\n\n\nbit<16> x; // WIDTH\n\nbit<WIDTH> y;\n", *result);
+}
+
+TEST_F(Preprocessor, Conditionals) {
+    auto file = write("conditionals.p4",
+                      "#if defined(A) && B >= 2 * (1 + 1)\n"
+                      "a\n"
+                      "#elif !defined C\n"
+                      "c\n"
+                      "#else\n"
+                      "other\n"
+                      "#endif\n"
+                      "#ifndef A\n"
+                      "#error not reached\n"
+                      "#endif\n");
+    P4::Preprocessor preprocessor;
+    EXPECT_TRUE(preprocessor.addOptions(" -DA -DB=0x4"));
+    auto result = preprocessor.process(file);
+    ASSERT_TRUE(result);
+    EXPECT_EQ("# 1 \"" + file + "\"\n\na\n\n\n\n\n\n\n\n\n", *result);
+
+    preprocessor.undefine("A");
+    result = preprocessor.process(file);
+    EXPECT_FALSE(result) << "#error must be left to cpp";
+}
+
+TEST_F(Preprocessor, Includes) {
+    auto header = write("include/header.p4",
+                        "#pragma once\n"
+                        "header h {}\n");
+    auto file = write("main.p4",
+                      "#include <header.p4>\n"
+                      "#include \"include/header.p4\"\n"
+                      "h x;\n");
+    P4::Preprocessor preprocessor;
+    preprocessor.addIncludeDir(dir / "include/");
+    auto result = preprocessor.process(file);
+    ASSERT_TRUE(result);
+    EXPECT_EQ("# 1 \"" + file + "\"\n# 1 \"" + header + "\" 1\n\nheader h {}\n# 2 \"" + file +
+                  "\" 2\n\nh x;\n",
+              *result);
+}
+
+TEST_F(Preprocessor, Unsupported) {
+    P4::Preprocessor preprocessor;
+    EXPECT_FALSE(preprocessor.addOptions(" -MD"));
+    EXPECT_FALSE(preprocessor.process(write("function.p4", "#define F(x) x\nF(1)\n")));
+    EXPECT_FALSE(preprocessor.process(write("line.p4", "__LINE__\n")));
+    EXPECT_FALSE(preprocessor.process(write("unterminated.p4", "#if 1\n")));
+    EXPECT_FALSE(preprocessor.process(write("missing.p4", "#include \"missing.p4\"\n")));
+    EXPECT_FALSE(preprocessor.process(dir / "nonexistent.p4"));
+}
+
+}  // namespace P4::Test
@@ -82,4 +82,35 @@ TEST_F(P4C_IR, InlineBlock) {
     EXPECT_TRUE(ifs->ifFalse->is<IR::BlockStatement>());
 }
 
+TEST_F(P4C_IR, SkipUnchangedSubtrees) {
+    struct CountAdds : public Transform {
+        CountAdds() { skipUnchangedSubtrees = true; }
+
+        const IR::Node *postorder(IR::Add *a) override {
+            ++adds;
+            return a;
+        }
+
+        int adds = 0;
+    };
+
+    const auto *left = new IR::Add(new IR::Constant(1), new IR::Constant(2));
+    const auto *right = new IR::Add(new IR::Constant(3), new IR::Constant(4));
+    const IR::Expression *e = new IR::Add(left, right);
+    CountAdds count;
+    EXPECT_EQ(e, e->apply(count));
+    EXPECT_EQ(count.adds, 3);
+
+    // Nothing changed since the last application.
+    count.adds = 0;
+    EXPECT_EQ(e, e->apply(count));
+    EXPECT_EQ(count.adds, 0);
+
+    // Only the new nodes are visited.
+    count.adds = 0;
+    const IR::Expression *e2 = new IR::Sub(new IR::Add(left, new IR::Constant(5)), right);
+    EXPECT_EQ(e2, e2->apply(count));
+    EXPECT_EQ(count.adds, 1);
+}
+
 }  // namespace P4::Test
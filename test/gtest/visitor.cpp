@@ -19,6 +19,7 @@ limitations under the License.
 #include "gtest/gtest.h"
 #include "helpers.h"
 #include "ir/ir.h"
+#include "ir/pass_utils.h"
 #include "midend_pass.h"
 
 namespace P4::Test {
@@ -160,4 +161,36 @@ TEST_F(P4CVisitor, MultiVisitModifierLoop) {
     ASSERT_TRUE(program != nullptr);
 }
 
+TEST_F(P4CVisitor, ParallelForEachDeclaration) {
+    auto *program = P4::parseP4String(R"(
+        header h_t { bit<8> f; }
+        control c1(inout h_t h) { apply { h.f = 1; } }
+        control c2(inout h_t h) { apply { h.f = 2; } }
+        parser p(out h_t h) { state start { transition accept; } }
+    )",
+                                      CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(program != nullptr);
+    ASSERT_EQ(program->objects.size(), 4u);
+
+    struct RenameControls : public Transform {
+        const IR::Node *postorder(IR::P4Control *control) override {
+            control->name = IR::ID(control->name.name + "_renamed");
+            return control;
+        }
+    };
+    const auto *result = program->apply(
+        ParallelForEachDeclaration([] { return new RenameControls; }, 2));
+    ASSERT_TRUE(result != nullptr);
+    ASSERT_NE(result, program);
+    ASSERT_EQ(result->objects.size(), 4u);
+    EXPECT_EQ(result->objects[0], program->objects[0]);
+    EXPECT_EQ(result->objects[1]->to<IR::P4Control>()->name.name, "c1_renamed");
+    EXPECT_EQ(result->objects[2]->to<IR::P4Control>()->name.name, "c2_renamed");
+    EXPECT_EQ(result->objects[3], program->objects[3]);
+
+    // Declarations not touched by the visitor leave the program unchanged.
+    struct Nothing : public Inspector {};
+    EXPECT_EQ(program->apply(ParallelForEachDeclaration([] { return new Nothing; })), program);
+}
+
 }  // namespace P4::Test